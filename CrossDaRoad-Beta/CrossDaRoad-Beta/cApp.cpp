@@ -27,6 +27,8 @@ cApp::cApp()
 	Zone.SetCellSize(app_const::CELL_SIZE, app_const::CELL_SIZE);
 	Player = hPlayer(this);
 	MapDrawer = hMapDrawer(this);
+	TextDrawer = hTextDrawer(this);
+	VisibilityMask = hVisibilityMask(this);
 	Menu.InitMenu();
 	GameInit();
 }
@@ -98,6 +100,9 @@ bool cApp::GameReset()
 		MapLoader.GetDangerPattern().c_str(),
 		MapLoader.GetBlockPattern().c_str()
 	);
+	MapDrawer.BuildLaneStrips();
+	MapDrawer.BuildStaticLayer();
+	sAppName += MapDrawer.ShowStaticLanes(); // Reported once per level, ahead of the FPS suffix
 	return true;
 }
 
@@ -253,22 +258,32 @@ bool cApp::OnPlayerDeath()
 	return true;
 }
 /// @brief Draw all lanes, render Player, draw status bar
+/// @brief Draws are recorded with their layer and drawn in batches at the end, then dark maps are masked
 /// @return Always returns true by default
 bool cApp::OnGameRender()
 {
+	BeginBatch();
 	DrawAllLanes();
 	Player.OnRenderPlayer();
 	DrawStatusBar();
+	EndBatch();
+	VisibilityMask.Apply();
+	SetDrawLayer(app_const::LAYER_LANE_BACKGROUND);
 	return true;
 }
-/// @brief Set frame delay, load all sprites, open menu
+/// @brief Set frame delay, load all sprites, open menu (or start the game for headless runs)
 /// @return Always returns true by default
 bool cApp::OnCreateEvent()
 {
 	Menu.SetupTarget(this);
 	SetFrameDelay(FrameDelay::STABLE_FPS_DELAY);
 	cAssetManager::GetInstance().LoadAllSprites();
-	Menu.OpenMenu();
+	if (GetFrameLimit() > 0) { // Headless runs have no input to leave the menu
+		Menu.StartGame();
+	}
+	else {
+		Menu.OpenMenu();
+	}
 	return true;
 }
 /// @brief
@@ -297,6 +312,12 @@ bool cApp::OnUpdateEvent(const float fElapsedTime)
 /// @return Always returns true by default
 bool cApp::OnLateUpdateEvent(float fElapsedTime, float fLateElapsedTime)
 {
+	// The visible area follows the player once it has moved, the frame is masked by OnGameRender()
+	const float fCellSize = static_cast<float>(nCellSize);
+	const int nCenterX = static_cast<int>((Player.GetPlayerAnimationPositionX() + 0.5f) * fCellSize);
+	const int nCenterY = static_cast<int>((Player.GetPlayerAnimationPositionY() + 0.5f) * fCellSize);
+	VisibilityMask.SetVisibility(MapLoader.GetVisibility());
+	VisibilityMask.SetCenter(nCenterX, nCenterY);
 	return true;
 }
 /// @brief 
@@ -525,16 +546,7 @@ bool cApp::DrawAllLanes() const
 /// @return true if text was drawn successfully, false otherwise
 bool cApp::DrawBigText(const std::string& sText, const int x, const int y)
 {
-	int i = 0;
-	for (const auto c : sText) {
-		constexpr int nFirstASCII = 32;
-		constexpr int nCharsInRow = 16;
-		const int nDrawX = ((c - nFirstASCII) % nCharsInRow) * app_const::FONT_WIDTH;
-		const int nDrawY = ((c - nFirstASCII) / nCharsInRow) * app_const::FONT_HEIGHT;
-		DrawPartialSprite(x + i * app_const::FONT_WIDTH, y, cAssetManager::GetInstance().GetSprite("font"), nDrawX, nDrawY, app_const::FONT_WIDTH, app_const::FONT_HEIGHT);
-		i++;
-	}
-	return true;
+	return TextDrawer.DrawString(sText, x, y);
 }
 
 /// @brief Draw the status bar beside the game map
@@ -543,7 +555,7 @@ bool cApp::DrawStatusBar()
 {
 	const std::string score_board_dynamic = "score_bar" + ShowFrameID(4, 0.005f);
 	const auto object = cAssetManager::GetInstance().GetSprite(score_board_dynamic);
-	constexpr int32_t nOffSetX_sb = 272;
+	constexpr int32_t nOffSetX_sb = app_const::FIELD_WIDTH;
 	constexpr int32_t nOffSetY_sb = 0;
 	constexpr int32_t nOriginX_sb = 0;
 	constexpr int32_t nOriginY_sb = 0;
@@ -552,10 +564,14 @@ bool cApp::DrawStatusBar()
 
 	constexpr int32_t nPosX_level = 321;
 	constexpr int32_t nPosY_level = 90;
+	PushClipRect(nOffSetX_sb, nOffSetY_sb, nWidth_sb, nHeight_sb);
+	SetDrawLayer(app_const::LAYER_STATUS_BAR);
 	DrawPartialSprite(nOffSetX_sb, nOffSetY_sb, object, nOriginX_sb, nOriginY_sb, nWidth_sb, nHeight_sb);
+	SetDrawLayer(app_const::LAYER_STATUS_TEXT);
 	SetPixelMode(app::Pixel::MASK);
 	DrawBigText(MapLoader.ShowMapLevel(), nPosX_level, nPosY_level);
 	SetPixelMode(app::Pixel::NORMAL);
+	PopClipRect();
 	return true;
 }
 
@@ -19,6 +19,8 @@
 #include "cAssetManager.h"
 #include "cMapLoader.h"
 #include "hMapDrawer.h"
+#include "hTextDrawer.h"
+#include "hVisibilityMask.h"
 #include "cFrame.h"
 // Event Handlers
 #include "hPlayer.h"
@@ -44,6 +46,8 @@ private: // Reinitializable Properties (depended on each map)
 	cZone Zone;
 	cMapLoader MapLoader;
 	hMapDrawer MapDrawer;
+	hTextDrawer TextDrawer;
+	hVisibilityMask VisibilityMask;
 
 private: // Customizable Properties (applied to all maps)
 	int nLaneWidth;
@@ -167,10 +167,11 @@ bool cAssetManager::LoadExitSprites()
 bool cAssetManager::LoadPauseSprites()
 {
     bool bSuccess = true;
-    bSuccess &= LoadSprite("black_alpha", "black_alpha170");
-    bSuccess &= LoadSprite("pause_exit", "pause_exit");
-    bSuccess &= LoadSprite("pause_resume", "pause_resume");
-    bSuccess &= LoadSprite("pause_save", "pause_save");
+    // Pause sprites are layered over the game render in app::Pixel::PREMULTIPLIED mode
+    bSuccess &= LoadSprite("black_alpha", "black_alpha170", true);
+    bSuccess &= LoadSprite("pause_exit", "pause_exit", true);
+    bSuccess &= LoadSprite("pause_resume", "pause_resume", true);
+    bSuccess &= LoadSprite("pause_save", "pause_save", true);
 
     return ReportLoadingResult(bSuccess, "pause");
 }
@@ -203,7 +204,6 @@ bool cAssetManager::LoadPlayerIdleSprites()
 {
     bool bSuccess = true;
     bSuccess &= LoadSprite("froggy", "froggy");
-    bSuccess &= LoadSprite("froggy_left", "froggy_left");
 
     return ReportLoadingResult(bSuccess, "player idle");
 }
@@ -213,7 +213,6 @@ bool cAssetManager::LoadPlayerJumpSprites()
 {
     bool bSuccess = true;
     bSuccess &= LoadAnimation("froggy_jump", "froggy_jump", 6);
-    bSuccess &= LoadAnimation("froggy_jump_left", "froggy_jump_left", 6);
 
     return ReportLoadingResult(bSuccess, "player jump");
 }
@@ -261,7 +260,6 @@ bool cAssetManager::LoadMapRiverSideSprites()
     bSuccess &= LoadSprite("tree", "tree");
     bSuccess &= LoadSprite("grass", "grass");
     bSuccess &= LoadAnimation("crocodile", "crocodile", 6);
-    bSuccess &= LoadAnimation("crocodile_right", "crocodile_right", 6);
 
     return ReportLoadingResult(bSuccess, "River Side map");
 }
@@ -314,15 +312,19 @@ bool cAssetManager::LoadMapOceanSprites()
 /// @brief Load particular sprite
 /// @param sName Name of sprite that will be stored in map of sprites
 /// @param sFileName Name of file that contains sprite
+/// @param bPremultiplied True to premultiply the sprite by its alpha once, for app::Pixel::PREMULTIPLIED draws
 /// @return True if loading is successful, false otherwise
-bool cAssetManager::LoadSprite(const std::string& sName, const std::string& sFileName)
+bool cAssetManager::LoadSprite(const std::string& sName, const std::string& sFileName, const bool bPremultiplied)
 {
     auto* spr = new app::Sprite(GetFileLocation(sFileName));
-    if (spr == nullptr || spr->GetData() == nullptr) {
+    if (spr == nullptr || spr->Width() <= 0 || spr->Height() <= 0) { // Pixel data may be stored indexed
         std::cerr << "cAssetManager::LoadSprite(name=\"" << sName << "\", filename=\"" << sFileName << "\"): ";
         std::cerr << "Can not found with file \"" << GetFileLocation(sFileName) << "\"" << std::endl;
         return false;
     }
+    if (bPremultiplied) {
+        spr->Premultiply();
+    }
     mapSprites[sName] = spr;
     return true;
 }
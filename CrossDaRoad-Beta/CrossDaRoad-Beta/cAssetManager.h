@@ -63,7 +63,7 @@ private: // Map Loaders
 	bool LoadMapOceanSprites();
 
 private: // Loaders
-	bool LoadSprite(const std::string& sName, const std::string& sFileName);
+	bool LoadSprite(const std::string& sName, const std::string& sFileName, bool bPremultiplied = false);
 	bool LoadAnimation(const std::string& sName, const std::string& sFileName, int nMaxFrame);
 
 public: // Loaders
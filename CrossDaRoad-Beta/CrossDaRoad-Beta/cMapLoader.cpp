@@ -7,8 +7,24 @@
 **/
 
 #include "cMapLoader.h"
+#include <algorithm>
 #include <iostream>
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////// MAP VISIBILITY ///////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Check if two visibilities darken the map the same way
+bool MapVisibility::operator==(const MapVisibility& other) const
+{
+	return nRadius == other.nRadius && nFalloff == other.nFalloff && nAmbient == other.nAmbient;
+}
+/// @brief Check if two visibilities darken the map differently
+bool MapVisibility::operator!=(const MapVisibility& other) const
+{
+	return !(*this == other);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////// CONSTRUCTORS & DESTRUCTOR ////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +72,7 @@ void cMapLoader::MapClear()
 {
 	mapSprites.clear();
 	vecLanes.clear();
+	visibility = MapVisibility();
 }
 /// @brief Load next map level
 void cMapLoader::NextLevel()
@@ -190,6 +207,11 @@ cMapLane cMapLoader::GetLaneCeil(float fPos) const
 {
 	return GetLane(static_cast<int>(std::ceil(fPos)));
 }
+/// @brief Getter for the visibility of the map (whole map visible unless the map file sets it)
+MapVisibility cMapLoader::GetVisibility() const
+{
+	return visibility;
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////// INFO GETTERS //////////////////////////////////////////////////
@@ -328,6 +350,20 @@ bool cMapLoader::LoadMapSprite(const std::string& sLine, bool bDebug)
 				else if (attribute == "backgroundY") {
 					currentSprite.nBackgroundPosY = std::stoi(value);
 				}
+				else if (attribute == "flipX") {
+					if (value == "true") {
+						currentSprite.isFlippedX = true;
+					}
+					else if (value == "false")
+						currentSprite.isFlippedX = false;
+				}
+				else if (attribute == "flipY") {
+					if (value == "true") {
+						currentSprite.isFlippedY = true;
+					}
+					else if (value == "false")
+						currentSprite.isFlippedY = false;
+				}
 				else if (attribute == "id") {
 					currentSprite.nID = std::stoi(value);
 				}
@@ -344,6 +380,12 @@ bool cMapLoader::LoadMapSprite(const std::string& sLine, bool bDebug)
 					value.pop_back();
 					currentSprite.fChance = std::stof(value);
 				}
+				else if (attribute == "reveal") {
+					currentSprite.nRevealRadius = std::max(0, std::stoi(value));
+				}
+				else if (attribute == "blend") {
+					currentSprite.eBlendMode = ExtractBlendMode(value);
+				}
 				else {
 					std::cerr << "Unknown attribute = \"" << attribute << "\" assigning value \"" << value << "\"";
 					std::cerr << std::endl;
@@ -359,6 +401,44 @@ bool cMapLoader::LoadMapSprite(const std::string& sLine, bool bDebug)
 	SetSpriteData(currentSprite);
 	return true;
 }
+/// @brief Load map properties (visibility=, falloff=, ambient=) from a line of the last map file section
+///	@param sLine - Line of properties, separated by spaces
+///	@param bDebug - If the assigned properties are printed
+///	@return true if every property was recognized, false otherwise
+bool cMapLoader::LoadMapProperty(const std::string& sLine, bool bDebug)
+{
+	std::istringstream iss(sLine);
+	bool bKnown = true;
+	for (std::string raw; iss >> raw;) {
+		const size_t equalPos = raw.find('=');
+		if (equalPos == std::string::npos) {
+			continue;
+		}
+		const std::string attribute = raw.substr(0, equalPos);
+		const std::string value = raw.substr(equalPos + 1);
+		if (attribute == "visibility") {
+			visibility.nRadius = std::max(0, std::stoi(value));
+		}
+		else if (attribute == "falloff") {
+			visibility.nFalloff = std::max(0, std::stoi(value));
+		}
+		else if (attribute == "ambient") {
+			visibility.nAmbient = std::min(std::max(0, std::stoi(value)), 255);
+		}
+		else if (attribute == "music") {
+			// kept by older maps, the soundtrack is chosen by the game, not by the map
+		}
+		else {
+			std::cerr << "Unknown property = \"" << attribute << "\" assigning value \"" << value << "\"" << std::endl;
+			bKnown = false;
+			continue;
+		}
+		if (bDebug) {
+			std::cerr << "Assign property " << attribute << " := " << value << std::endl;
+		}
+	}
+	return bKnown;
+}
 /// @brief Load map name from file
 ///	@param sFileName - File name (std::string)
 ///	@return true if map name was loaded successfully, false otherwise
@@ -416,6 +496,7 @@ bool cMapLoader::LoadMapLevel(const int& nMapLevel)
 
 	int nLaneID = 0;
 	bool bLoadingSprite = false;
+	bool bLoadingProperty = false;
 	for (std::string sLine; std::getline(ifs, sLine);) {
 		strutil::deduplicate(sLine, " ");
 		strutil::trim(sLine);
@@ -423,14 +504,18 @@ bool cMapLoader::LoadMapLevel(const int& nMapLevel)
 			break;
 
 		if (sLine.front() == '#') {
-			if (bLoadingSprite) {
+			if (bLoadingProperty) {
 				break;
 			}
+			bLoadingProperty = bLoadingSprite;
 			bLoadingSprite = true;
 			continue;
 		}
 
-		if (bLoadingSprite) {
+		if (bLoadingProperty) {
+			LoadMapProperty(sLine);
+		}
+		else if (bLoadingSprite) {
 			LoadMapSprite(sLine);
 		}
 		else {
@@ -505,6 +590,29 @@ float cMapLoader::ExtractTime(const std::string& timeStr)
 		return 0.0;
 	}
 }
+/// @brief Extract the pixel mode of a sprite from its name
+/// @param modeStr Mode string (mask, alpha, add, multiply or screen)
+/// @return Pixel mode, app::Pixel::MASK if the name is unknown
+app::Pixel::Mode cMapLoader::ExtractBlendMode(const std::string& modeStr)
+{
+	if (modeStr == "mask") {
+		return app::Pixel::MASK;
+	}
+	if (modeStr == "alpha") {
+		return app::Pixel::ALPHA;
+	}
+	if (modeStr == "add") {
+		return app::Pixel::ADD;
+	}
+	if (modeStr == "multiply") {
+		return app::Pixel::MULTIPLY;
+	}
+	if (modeStr == "screen") {
+		return app::Pixel::SCREEN;
+	}
+	std::cerr << "Unrecognized blend mode: " << modeStr << std::endl;
+	return app::Pixel::MASK;
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////// END OF FILE /////////////////////////////////////////////////////
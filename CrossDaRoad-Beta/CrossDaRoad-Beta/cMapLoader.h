@@ -20,6 +20,16 @@
 #include <cmath>
 #include <map>
 
+/// @brief Visibility of a dark map, read from the properties section of the map file
+struct MapVisibility
+{
+	int nRadius = 0;      ///< Radius of the visible area around the player (in pixels), 0 if the whole map is visible
+	int nFalloff = 0;     ///< Width of the fading edge inside the radius (in pixels)
+	int nAmbient = 255;   ///< Brightness outside the radius (0 is black, 255 is fully lit)
+
+	bool operator==(const MapVisibility& other) const;
+	bool operator!=(const MapVisibility& other) const;
+};
 
 /// @brief Class for map loader and manipulation in game
 class cMapLoader
@@ -34,6 +44,7 @@ private:
 	MapObject currentSprite; ///< Current sprite data
 	std::string dangerPattern; ///< Danger pattern for map
 	std::string blockPattern; ///< Block pattern for map
+	MapVisibility visibility; ///< Visibility of the map
 	int nMapLevel; ///< Current map level
 
 public: // Constructors & Destructors
@@ -67,6 +78,7 @@ public: // Getters
 	cMapLane GetLaneFloor(float fPos) const;
 	cMapLane GetLaneRound(float fPos) const;
 	cMapLane GetLaneCeil(float fPos) const;
+	MapVisibility GetVisibility() const;
 
 public: // Info getters
 	std::string ShowMapLevel() const;
@@ -79,6 +91,7 @@ public: // Setters
 private: // Loaders
 	bool LoadMapLane(const std::string& sLine, int nLineID = 0, bool bDebug = false);
 	bool LoadMapSprite(const std::string& sLine, bool bDebug = false);
+	bool LoadMapProperty(const std::string& sLine, bool bDebug = false);
 	bool LoadMapName(const std::string& sFileName);
 	bool LoadMapLevel(const int& nMapLevel);
 
@@ -87,6 +100,7 @@ public: // Loaders
 
 private: // Utilities
 	static float ExtractTime(const std::string& timeStr);
+	static app::Pixel::Mode ExtractBlendMode(const std::string& modeStr);
 };
 
 #endif // C_MAP_LOADER_H
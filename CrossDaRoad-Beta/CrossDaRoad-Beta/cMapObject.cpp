@@ -26,11 +26,15 @@ MapObject::MapObject()
 	nSpritePosY = 0;
 	nBackgroundPosX = 0;
 	nBackgroundPosY = 0;
+	isFlippedX = false;
+	isFlippedY = false;
 	nID = 0;
 	summon = 0;
 	fDuration = 0;
 	fCooldown = 0;
 	fChance = 0;
+	nRevealRadius = 0;
+	eBlendMode = app::Pixel::MASK;
 }
 
 /// @brief Destructor
@@ -74,6 +78,10 @@ void MapObject::debug(char end) const
 		std::cerr << ", ";
 		std::cerr << "backgroundY=" << nBackgroundPosY;
 		std::cerr << ", ";
+		std::cerr << "flipX=" << std::boolalpha << isFlippedX;
+		std::cerr << ", ";
+		std::cerr << "flipY=" << std::boolalpha << isFlippedY;
+		std::cerr << ", ";
 		std::cerr << "id=" << nID;
 		std::cerr << "]\n";
 	}
@@ -86,6 +94,10 @@ void MapObject::debug(char end) const
 		std::cerr << "cooldown=" << fCooldown << "s";
 		std::cerr << ", ";
 		std::cerr << "chance=" << fChance << "%";
+		std::cerr << ", ";
+		std::cerr << "reveal=" << nRevealRadius;
+		std::cerr << ", ";
+		std::cerr << "blend=" << static_cast<int>(eBlendMode);
 		std::cerr << "]\n";
 	}
 	std::cerr << "}" << end;
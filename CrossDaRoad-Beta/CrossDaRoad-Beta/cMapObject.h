@@ -9,6 +9,8 @@
 #ifndef C_MAP_OBJECT_H
 #define C_MAP_OBJECT_H
 
+#include "gPixel.h"
+#include <cstdint>
 #include <string>
 
  /// @brief Sprite data for drawing and collision detection (block, danger, platform, etc.)
@@ -25,12 +27,16 @@ struct MapObject
 	int32_t nSpritePosY;        ///< Y initial position for drawing sprite
 	int32_t nBackgroundPosX;    ///< X initial position for drawing background
 	int32_t nBackgroundPosY;    ///< Y initial position for drawing background
+	bool isFlippedX;            ///< If the sprite is drawn mirrored left to right
+	bool isFlippedY;            ///< If the sprite is drawn mirrored top to bottom
 	int32_t nID;                ///< The ID of the sprite, for player customization
 
 	char summon;			    ///< The chance of summoning another sprite with encoded = summon
 	float fDuration;            ///< The duration (in seconds) of that sprite to be appeared
 	float fCooldown;            ///< The cooldown durations for the two consecutive summoning
 	float fChance;              ///< The probability of summoning in each second
+	int32_t nRevealRadius;      ///< Distance (in pixels) from the player within which the sprite fades in, 0 if always visible
+	app::Pixel::Mode eBlendMode;///< Pixel mode the sprite is drawn with, app::Pixel::MASK unless a light effect is set
 
 	// Methods
 	MapObject();						///< Constructor
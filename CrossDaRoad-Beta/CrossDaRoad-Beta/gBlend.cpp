@@ -0,0 +1,537 @@
+/**
+ * @file gBlend.cpp
+ *
+ * @brief Contains row blending kernels implementation
+ *
+ * This file implements scalar, SSE2 and AVX2 row kernels for blending spans of pixels.
+ * All kernels use the same 8-bit fixed-point arithmetic, so they produce identical pixels.
+**/
+
+#include "gBlend.h"
+#include "gSimd.h"
+#include <cstring>
+
+namespace app
+{
+	namespace kernel
+	{
+		//////////////////////////////////////////////////////////////////////////////////////////
+		////////////////////////////////// FEATURE DETECTION /////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Query the CPU (and the OS for AVX state saving) for the widest usable instruction set
+		/// @return The widest instruction set the kernels can use
+		static InstructionSet DetectInstructionSet()
+		{
+#ifdef G_SIMD_X86
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			const int nMaxLeaf = info[0];
+			__cpuid(info, 1);
+			const bool bSSE2 = (info[3] & (1 << 26)) != 0;
+			const bool bOSXSAVE = (info[2] & (1 << 27)) != 0;
+			const bool bAVX = (info[2] & (1 << 28)) != 0;
+			bool bAVX2 = false;
+			if (nMaxLeaf >= 7 && bOSXSAVE && bAVX && (_xgetbv(0) & 6) == 6) {
+				__cpuidex(info, 7, 0);
+				bAVX2 = (info[1] & (1 << 5)) != 0;
+			}
+#else
+			__builtin_cpu_init();
+			const bool bSSE2 = __builtin_cpu_supports("sse2");
+			const bool bAVX2 = __builtin_cpu_supports("avx2");
+#endif
+			if (bAVX2) {
+				return AVX2;
+			}
+			if (bSSE2) {
+				return SSE2;
+			}
+#endif
+			return SCALAR;
+		}
+
+		static const InstructionSet eInstructionSet = DetectInstructionSet(); ///< Resolved once at startup
+
+		/// @brief Getter for the instruction set used by the row kernels
+		InstructionSet GetInstructionSet()
+		{
+			return eInstructionSet;
+		}
+		/// @brief Getter for the name of the instruction set used by the row kernels
+		const char* ShowInstructionSet()
+		{
+			switch (eInstructionSet) {
+			case AVX2:
+				return "AVX2";
+			case SSE2:
+				return "SSE2";
+			default:
+				return "SCALAR";
+			}
+		}
+		/// @brief Convert a blend factor (0.0-1.0) to its 8-bit fixed-point weight (0-255)
+		/// @param fBlendFactor The blend factor
+		/// @return The rounded 8-bit weight
+		uint8_t ToFactor(const float fBlendFactor)
+		{
+			if (fBlendFactor <= 0.0f) {
+				return 0;
+			}
+			if (fBlendFactor >= 1.0f) {
+				return 255;
+			}
+			return static_cast<uint8_t>(fBlendFactor * 255.0f + 0.5f);
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//////////////////////////////////// ALPHA BLENDING //////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Portable alpha blend kernel, one pixel at a time
+		static void AlphaBlendScalar(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			for (int32_t i = 0; i < nLength; i++) {
+				pDst[i] = AlphaBlendPixel(pSrc[i], pDst[i], uFactor);
+			}
+		}
+
+#ifdef G_SIMD_X86
+		/// @brief Blend eight 16-bit channels with the same rounding as LerpChannel()
+		G_TARGET_SSE2 static inline __m128i LerpSSE2(const __m128i src, const __m128i dst, const __m128i w, const __m128i iw)
+		{
+			const __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(src, w), _mm_mullo_epi16(dst, iw)), _mm_set1_epi16(128));
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		}
+
+		/// @brief SSE2 alpha blend kernel, four pixels at a time
+		G_TARGET_SSE2 static void AlphaBlendSSE2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i w = _mm_set1_epi16(uFactor);
+			const __m128i iw = _mm_set1_epi16(static_cast<int16_t>(255 - uFactor));
+			int32_t i = 0;
+			for (; i + 4 <= nLength; i += 4) {
+				const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+				const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDst + i));
+				const __m128i lo = LerpSSE2(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero), w, iw);
+				const __m128i hi = LerpSSE2(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero), w, iw);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packus_epi16(lo, hi));
+			}
+			AlphaBlendScalar(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+
+		/// @brief Blend sixteen 16-bit channels with the same rounding as LerpChannel()
+		G_TARGET_AVX2 static inline __m256i LerpAVX2(const __m256i src, const __m256i dst, const __m256i w, const __m256i iw)
+		{
+			const __m256i t = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(src, w), _mm256_mullo_epi16(dst, iw)), _mm256_set1_epi16(128));
+			return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+		}
+
+		/// @brief AVX2 alpha blend kernel, eight pixels at a time (unpack and pack both work per 128-bit lane)
+		G_TARGET_AVX2 static void AlphaBlendAVX2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i w = _mm256_set1_epi16(uFactor);
+			const __m256i iw = _mm256_set1_epi16(static_cast<int16_t>(255 - uFactor));
+			int32_t i = 0;
+			for (; i + 8 <= nLength; i += 8) {
+				const __m256i src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+				const __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDst + i));
+				const __m256i lo = LerpAVX2(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(dst, zero), w, iw);
+				const __m256i hi = LerpAVX2(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(dst, zero), w, iw);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), _mm256_packus_epi16(lo, hi));
+			}
+			AlphaBlendSSE2(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+#endif // G_SIMD_X86
+
+		/// @brief Blend a span of source pixels over the destination with a constant weight
+		/// @param pDst The destination span (blended in place)
+		/// @param pSrc The source span
+		/// @param nLength The number of pixels in both spans
+		/// @param uFactor The weight of the source pixels (0-255), see ToFactor()
+		void AlphaBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			switch (eInstructionSet) {
+#ifdef G_SIMD_X86
+			case AVX2:
+				return AlphaBlendAVX2(pDst, pSrc, nLength, uFactor);
+			case SSE2:
+				return AlphaBlendSSE2(pDst, pSrc, nLength, uFactor);
+#endif
+			default:
+				return AlphaBlendScalar(pDst, pSrc, nLength, uFactor);
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		////////////////////////////////// PREMULTIPLIED ALPHA ///////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Portable premultiplied blend kernel, one pixel at a time
+		static void PremultipliedBlendScalar(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			for (int32_t i = 0; i < nLength; i++) {
+				pDst[i] = PremultipliedBlendPixel(pSrc[i], pDst[i], uFactor);
+			}
+		}
+
+#ifdef G_SIMD_X86
+		/// @brief Multiply eight 16-bit channels as fractions of 255, with the same rounding as MulChannel()
+		G_TARGET_SSE2 static inline __m128i MulSSE2(const __m128i x, const __m128i y)
+		{
+			const __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(128));
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		}
+
+		/// @brief Multiply the channels of four pixels by 16-bit weights as fractions of 255
+		/// @note Red/blue and green/alpha are multiplied as the low and high bytes of 16-bit lanes,
+		///       so pixels are never unpacked and no shuffle is needed
+		G_TARGET_SSE2 static inline __m128i MulPixelsSSE2(const __m128i pixels, const __m128i w)
+		{
+			const __m128i rb = MulSSE2(_mm_and_si128(pixels, _mm_set1_epi16(0x00FF)), w);
+			const __m128i ga = MulSSE2(_mm_srli_epi16(pixels, 8), w);
+			return _mm_or_si128(rb, _mm_slli_epi16(ga, 8));
+		}
+
+		/// @brief Composite four premultiplied pixels over four destination pixels (the add saturates like the scalar kernel)
+		template <bool bWeighted>
+		G_TARGET_SSE2 static inline __m128i OverSSE2(__m128i src, const __m128i dst, const __m128i w)
+		{
+			if (bWeighted) {
+				src = MulPixelsSSE2(src, w);
+			}
+			const __m128i inverse = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(src, 24));
+			return _mm_adds_epu8(src, MulPixelsSSE2(dst, _mm_or_si128(inverse, _mm_slli_epi32(inverse, 16))));
+		}
+
+		/// @brief SSE2 premultiplied blend loop, four pixels at a time
+		/// @return Number of pixels blended, a multiple of four
+		template <bool bWeighted>
+		G_TARGET_SSE2 static int32_t PremultipliedBlendLoopSSE2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m128i w = _mm_set1_epi16(uFactor);
+			int32_t i = 0;
+			for (; i + 4 <= nLength; i += 4) {
+				const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+				const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDst + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), OverSSE2<bWeighted>(src, dst, w));
+			}
+			return i;
+		}
+
+		/// @brief SSE2 premultiplied blend kernel, without the weight multiply for a fully opaque span
+		G_TARGET_SSE2 static void PremultipliedBlendSSE2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const int32_t i = (uFactor == 255) ? PremultipliedBlendLoopSSE2<false>(pDst, pSrc, nLength, uFactor) : PremultipliedBlendLoopSSE2<true>(pDst, pSrc, nLength, uFactor);
+			PremultipliedBlendScalar(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+
+		/// @brief Multiply sixteen 16-bit channels as fractions of 255, with the same rounding as MulChannel()
+		G_TARGET_AVX2 static inline __m256i MulAVX2(const __m256i x, const __m256i y)
+		{
+			const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(x, y), _mm256_set1_epi16(128));
+			return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+		}
+
+		/// @brief Multiply the channels of eight pixels by 16-bit weights as fractions of 255, see MulPixelsSSE2()
+		G_TARGET_AVX2 static inline __m256i MulPixelsAVX2(const __m256i pixels, const __m256i w)
+		{
+			const __m256i rb = MulAVX2(_mm256_and_si256(pixels, _mm256_set1_epi16(0x00FF)), w);
+			const __m256i ga = MulAVX2(_mm256_srli_epi16(pixels, 8), w);
+			return _mm256_or_si256(rb, _mm256_slli_epi16(ga, 8));
+		}
+
+		/// @brief Composite eight premultiplied pixels over eight destination pixels
+		template <bool bWeighted>
+		G_TARGET_AVX2 static inline __m256i OverAVX2(__m256i src, const __m256i dst, const __m256i w)
+		{
+			if (bWeighted) {
+				src = MulPixelsAVX2(src, w);
+			}
+			const __m256i inverse = _mm256_sub_epi32(_mm256_set1_epi32(255), _mm256_srli_epi32(src, 24));
+			return _mm256_adds_epu8(src, MulPixelsAVX2(dst, _mm256_or_si256(inverse, _mm256_slli_epi32(inverse, 16))));
+		}
+
+		/// @brief AVX2 premultiplied blend loop, eight pixels at a time
+		/// @return Number of pixels blended, a multiple of eight
+		template <bool bWeighted>
+		G_TARGET_AVX2 static int32_t PremultipliedBlendLoopAVX2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m256i w = _mm256_set1_epi16(uFactor);
+			int32_t i = 0;
+			for (; i + 8 <= nLength; i += 8) {
+				const __m256i src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+				const __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDst + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), OverAVX2<bWeighted>(src, dst, w));
+			}
+			return i;
+		}
+
+		/// @brief AVX2 premultiplied blend kernel, without the weight multiply for a fully opaque span
+		G_TARGET_AVX2 static void PremultipliedBlendAVX2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const int32_t i = (uFactor == 255) ? PremultipliedBlendLoopAVX2<false>(pDst, pSrc, nLength, uFactor) : PremultipliedBlendLoopAVX2<true>(pDst, pSrc, nLength, uFactor);
+			PremultipliedBlendSSE2(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+#endif // G_SIMD_X86
+
+		/// @brief Composite a span of premultiplied source pixels over the destination
+		/// @param pDst The destination span (blended in place)
+		/// @param pSrc The source span, premultiplied by its alpha (see Sprite::Premultiply())
+		/// @param nLength The number of pixels in both spans
+		/// @param uFactor The opacity of the whole span (0-255), see ToFactor()
+		void PremultipliedBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			switch (eInstructionSet) {
+#ifdef G_SIMD_X86
+			case AVX2:
+				return PremultipliedBlendAVX2(pDst, pSrc, nLength, uFactor);
+			case SSE2:
+				return PremultipliedBlendSSE2(pDst, pSrc, nLength, uFactor);
+#endif
+			default:
+				return PremultipliedBlendScalar(pDst, pSrc, nLength, uFactor);
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////////// MODULATION ///////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Portable modulation kernel, one pixel at a time
+		static void ModulateScalar(Pixel* pDst, const uint8_t* pWeights, const int32_t nLength)
+		{
+			for (int32_t i = 0; i < nLength; i++) {
+				pDst[i] = ModulatePixel(pDst[i], pWeights[i]);
+			}
+		}
+
+#ifdef G_SIMD_X86
+		/// @brief Multiply the colour of four pixels by their 32-bit weights, keeping alpha (weight 255 on the alpha lane)
+		G_TARGET_SSE2 static inline __m128i ModulatePixelsSSE2(const __m128i pixels, const __m128i w)
+		{
+			const __m128i rb = MulSSE2(_mm_and_si128(pixels, _mm_set1_epi16(0x00FF)), _mm_or_si128(w, _mm_slli_epi32(w, 16)));
+			const __m128i ga = MulSSE2(_mm_srli_epi16(pixels, 8), _mm_or_si128(w, _mm_set1_epi32(255 << 16)));
+			return _mm_or_si128(rb, _mm_slli_epi16(ga, 8));
+		}
+
+		/// @brief SSE2 modulation kernel, four pixels at a time
+		G_TARGET_SSE2 static void ModulateSSE2(Pixel* pDst, const uint8_t* pWeights, const int32_t nLength)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			int32_t i = 0;
+			for (; i + 4 <= nLength; i += 4) {
+				int32_t nWeights;
+				std::memcpy(&nWeights, pWeights + i, sizeof(nWeights));
+				const __m128i w = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(nWeights), zero), zero);
+				const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDst + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), ModulatePixelsSSE2(dst, w));
+			}
+			ModulateScalar(pDst + i, pWeights + i, nLength - i);
+		}
+
+		/// @brief Multiply the colour of eight pixels by their 32-bit weights, see ModulatePixelsSSE2()
+		G_TARGET_AVX2 static inline __m256i ModulatePixelsAVX2(const __m256i pixels, const __m256i w)
+		{
+			const __m256i rb = MulAVX2(_mm256_and_si256(pixels, _mm256_set1_epi16(0x00FF)), _mm256_or_si256(w, _mm256_slli_epi32(w, 16)));
+			const __m256i ga = MulAVX2(_mm256_srli_epi16(pixels, 8), _mm256_or_si256(w, _mm256_set1_epi32(255 << 16)));
+			return _mm256_or_si256(rb, _mm256_slli_epi16(ga, 8));
+		}
+
+		/// @brief AVX2 modulation kernel, eight pixels at a time
+		G_TARGET_AVX2 static void ModulateAVX2(Pixel* pDst, const uint8_t* pWeights, const int32_t nLength)
+		{
+			int32_t i = 0;
+			for (; i + 8 <= nLength; i += 8) {
+				const __m256i w = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pWeights + i)));
+				const __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDst + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), ModulatePixelsAVX2(dst, w));
+			}
+			ModulateSSE2(pDst + i, pWeights + i, nLength - i);
+		}
+#endif // G_SIMD_X86
+
+		/// @brief Darken a span of pixels by per-pixel weights (alpha is kept)
+		/// @param pDst The span to modulate in place
+		/// @param pWeights One weight per pixel (0 is black, 255 leaves the pixel unchanged)
+		/// @param nLength The number of pixels
+		void ModulateRow(Pixel* pDst, const uint8_t* pWeights, const int32_t nLength)
+		{
+			switch (eInstructionSet) {
+#ifdef G_SIMD_X86
+			case AVX2:
+				return ModulateAVX2(pDst, pWeights, nLength);
+			case SSE2:
+				return ModulateSSE2(pDst, pWeights, nLength);
+#endif
+			default:
+				return ModulateScalar(pDst, pWeights, nLength);
+			}
+		}
+		//////////////////////////////////////////////////////////////////////////////////////////
+		///////////////////////////////////// LIGHT EFFECTS //////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Blend one pixel with the light effect of the given mode (Pixel::ADD, Pixel::MULTIPLY or Pixel::SCREEN)
+		template <Pixel::Mode eMode>
+		static inline Pixel LightBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			return (eMode == Pixel::ADD) ? AddBlendPixel(src, dst, uFactor)
+				: (eMode == Pixel::MULTIPLY) ? MultiplyBlendPixel(src, dst, uFactor)
+				: ScreenBlendPixel(src, dst, uFactor);
+		}
+
+		/// @brief Portable light effect kernel, one pixel at a time
+		template <Pixel::Mode eMode>
+		static void LightBlendScalar(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			for (int32_t i = 0; i < nLength; i++) {
+				pDst[i] = LightBlendPixel<eMode>(pSrc[i], pDst[i], uFactor);
+			}
+		}
+
+#ifdef G_SIMD_X86
+		/// @brief Multiply the channels of four pixels by the channels of four other pixels as fractions of 255
+		G_TARGET_SSE2 static inline __m128i MulChannelsSSE2(const __m128i x, const __m128i y)
+		{
+			const __m128i mask = _mm_set1_epi16(0x00FF);
+			const __m128i rb = MulSSE2(_mm_and_si128(x, mask), _mm_and_si128(y, mask));
+			const __m128i ga = MulSSE2(_mm_srli_epi16(x, 8), _mm_srli_epi16(y, 8));
+			return _mm_or_si128(rb, _mm_slli_epi16(ga, 8));
+		}
+
+		/// @brief Apply the light effect of four source pixels to four destination pixels, keeping the destination alpha
+		/// @note Each source pixel is weighted by its alpha times w, so transparent pixels leave the destination unchanged
+		template <Pixel::Mode eMode>
+		G_TARGET_SSE2 static inline __m128i LightSSE2(const __m128i src, const __m128i dst, const __m128i w)
+		{
+			const __m128i ones = _mm_set1_epi32(-1);
+			const __m128i alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+			const __m128i k = MulSSE2(_mm_srli_epi32(src, 24), w);
+			const __m128i weight = _mm_or_si128(k, _mm_slli_epi32(k, 16));
+			__m128i result;
+			if (eMode == Pixel::ADD) {
+				result = _mm_adds_epu8(dst, MulPixelsSSE2(src, weight));
+			}
+			else if (eMode == Pixel::MULTIPLY) {
+				const __m128i factor = _mm_xor_si128(MulPixelsSSE2(_mm_xor_si128(src, ones), weight), ones);
+				result = MulChannelsSSE2(dst, factor);
+			}
+			else {
+				result = _mm_add_epi8(dst, MulChannelsSSE2(MulPixelsSSE2(src, weight), _mm_xor_si128(dst, ones)));
+			}
+			return _mm_or_si128(_mm_andnot_si128(alpha, result), _mm_and_si128(dst, alpha));
+		}
+
+		/// @brief SSE2 light effect kernel, four pixels at a time
+		template <Pixel::Mode eMode>
+		G_TARGET_SSE2 static void LightBlendSSE2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m128i w = _mm_set1_epi16(uFactor);
+			int32_t i = 0;
+			for (; i + 4 <= nLength; i += 4) {
+				const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+				const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDst + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), LightSSE2<eMode>(src, dst, w));
+			}
+			LightBlendScalar<eMode>(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+
+		/// @brief Multiply the channels of eight pixels by the channels of eight other pixels, see MulChannelsSSE2()
+		G_TARGET_AVX2 static inline __m256i MulChannelsAVX2(const __m256i x, const __m256i y)
+		{
+			const __m256i mask = _mm256_set1_epi16(0x00FF);
+			const __m256i rb = MulAVX2(_mm256_and_si256(x, mask), _mm256_and_si256(y, mask));
+			const __m256i ga = MulAVX2(_mm256_srli_epi16(x, 8), _mm256_srli_epi16(y, 8));
+			return _mm256_or_si256(rb, _mm256_slli_epi16(ga, 8));
+		}
+
+		/// @brief Apply the light effect of eight source pixels to eight destination pixels, see LightSSE2()
+		template <Pixel::Mode eMode>
+		G_TARGET_AVX2 static inline __m256i LightAVX2(const __m256i src, const __m256i dst, const __m256i w)
+		{
+			const __m256i ones = _mm256_set1_epi32(-1);
+			const __m256i alpha = _mm256_set1_epi32(static_cast<int32_t>(0xFF000000));
+			const __m256i k = MulAVX2(_mm256_srli_epi32(src, 24), w);
+			const __m256i weight = _mm256_or_si256(k, _mm256_slli_epi32(k, 16));
+			__m256i result;
+			if (eMode == Pixel::ADD) {
+				result = _mm256_adds_epu8(dst, MulPixelsAVX2(src, weight));
+			}
+			else if (eMode == Pixel::MULTIPLY) {
+				const __m256i factor = _mm256_xor_si256(MulPixelsAVX2(_mm256_xor_si256(src, ones), weight), ones);
+				result = MulChannelsAVX2(dst, factor);
+			}
+			else {
+				result = _mm256_add_epi8(dst, MulChannelsAVX2(MulPixelsAVX2(src, weight), _mm256_xor_si256(dst, ones)));
+			}
+			return _mm256_or_si256(_mm256_andnot_si256(alpha, result), _mm256_and_si256(dst, alpha));
+		}
+
+		/// @brief AVX2 light effect kernel, eight pixels at a time
+		template <Pixel::Mode eMode>
+		G_TARGET_AVX2 static void LightBlendAVX2(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			const __m256i w = _mm256_set1_epi16(uFactor);
+			int32_t i = 0;
+			for (; i + 8 <= nLength; i += 8) {
+				const __m256i src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+				const __m256i dst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDst + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), LightAVX2<eMode>(src, dst, w));
+			}
+			LightBlendSSE2<eMode>(pDst + i, pSrc + i, nLength - i, uFactor);
+		}
+#endif // G_SIMD_X86
+
+		/// @brief Dispatch a light effect kernel on the instruction set resolved at startup
+		template <Pixel::Mode eMode>
+		static void LightBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			switch (eInstructionSet) {
+#ifdef G_SIMD_X86
+			case AVX2:
+				return LightBlendAVX2<eMode>(pDst, pSrc, nLength, uFactor);
+			case SSE2:
+				return LightBlendSSE2<eMode>(pDst, pSrc, nLength, uFactor);
+#endif
+			default:
+				return LightBlendScalar<eMode>(pDst, pSrc, nLength, uFactor);
+			}
+		}
+
+		/// @brief Brighten a span of destination pixels by adding the source colours (saturating, alpha is kept)
+		/// @param pDst The destination span (blended in place)
+		/// @param pSrc The source span, each pixel weighted by its own alpha
+		/// @param nLength The number of pixels in both spans
+		/// @param uFactor The strength of the whole span (0-255), see ToFactor()
+		void AddBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			LightBlendRow<Pixel::ADD>(pDst, pSrc, nLength, uFactor);
+		}
+		/// @brief Tint a span of destination pixels by multiplying them with the source colours (alpha is kept)
+		/// @param pDst The destination span (blended in place)
+		/// @param pSrc The source span, each pixel weighted by its own alpha
+		/// @param nLength The number of pixels in both spans
+		/// @param uFactor The strength of the whole span (0-255), see ToFactor()
+		void MultiplyBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			LightBlendRow<Pixel::MULTIPLY>(pDst, pSrc, nLength, uFactor);
+		}
+		/// @brief Lighten a span of destination pixels by screening them with the source colours (alpha is kept)
+		/// @param pDst The destination span (blended in place)
+		/// @param pSrc The source span, each pixel weighted by its own alpha
+		/// @param nLength The number of pixels in both spans
+		/// @param uFactor The strength of the whole span (0-255), see ToFactor()
+		void ScreenBlendRow(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+		{
+			LightBlendRow<Pixel::SCREEN>(pDst, pSrc, nLength, uFactor);
+		}
+	} // namespace kernel
+} // namespace app
+
+//////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////// END OF FILE ////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
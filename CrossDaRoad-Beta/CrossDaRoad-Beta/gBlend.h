@@ -0,0 +1,130 @@
+/**
+ * @file gBlend.h
+ *
+ * @brief Contains row blending kernels
+ *
+ * This file contains vectorized row kernels for blending spans of pixels (for graphics), with straight alpha
+ * (constant-weight lerp), premultiplied alpha (source over destination) or light effects (add, multiply, screen),
+ * and for darkening spans by per-pixel weights.
+**/
+
+#ifndef G_BLEND_H
+#define G_BLEND_H
+
+#include "gPixel.h"
+#include <cstdint>
+
+namespace app
+{
+	/// @brief Namespace for row kernels, selected once at startup by CPU feature detection
+	namespace kernel
+	{
+		/// @brief Enumeration of instruction sets the kernels can run on
+		enum InstructionSet
+		{
+			SCALAR, ///< Portable fallback, one pixel at a time
+			SSE2,   ///< 128-bit kernels, four pixels at a time
+			AVX2,   ///< 256-bit kernels, eight pixels at a time
+		};
+
+		/// @brief Blend one channel, (src * w + dst * (255 - w)) / 255 rounded to nearest
+		inline uint8_t LerpChannel(const uint32_t uSrc, const uint32_t uDst, const uint32_t uFactor)
+		{
+			const uint32_t t = uSrc * uFactor + uDst * (255 - uFactor) + 128;
+			return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+		}
+		/// @brief Blend one pixel with the same arithmetic as AlphaBlendRow()
+		inline Pixel AlphaBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			return {
+				LerpChannel(src.r, dst.r, uFactor),
+				LerpChannel(src.g, dst.g, uFactor),
+				LerpChannel(src.b, dst.b, uFactor),
+				LerpChannel(src.a, dst.a, uFactor)
+			};
+		}
+
+		/// @brief Multiply two channels as fractions of 255, x * y / 255 rounded to nearest like LerpChannel()
+		inline uint8_t MulChannel(const uint32_t x, const uint32_t y)
+		{
+			const uint32_t t = x * y + 128;
+			return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+		}
+		/// @brief Convert a straight-alpha pixel to premultiplied alpha
+		inline Pixel PremultiplyPixel(const Pixel& pixel)
+		{
+			return { MulChannel(pixel.r, pixel.a), MulChannel(pixel.g, pixel.a), MulChannel(pixel.b, pixel.a), pixel.a };
+		}
+		/// @brief Convert a premultiplied-alpha pixel back to straight alpha, exact for alpha 255,
+		///        otherwise the nearest colour that premultiplies to the same pixel
+		inline Pixel UnpremultiplyPixel(const Pixel& pixel)
+		{
+			if (pixel.a == 0) {
+				return { 0, 0, 0, 0 };
+			}
+			const auto Divide = [&pixel](const uint32_t c) {
+				const uint32_t t = (c * 255 + pixel.a / 2) / pixel.a;
+				return static_cast<uint8_t>(t < 255 ? t : 255);
+			};
+			return { Divide(pixel.r), Divide(pixel.g), Divide(pixel.b), pixel.a };
+		}
+		/// @brief Composite a premultiplied pixel over another, src * w + dst * (255 - src.a * w) with the same
+		///        arithmetic as PremultipliedBlendRow() (a single multiply-add per channel when w is 255)
+		inline Pixel PremultipliedBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			const Pixel weighted = (uFactor == 255) ? src : Pixel(MulChannel(src.r, uFactor), MulChannel(src.g, uFactor), MulChannel(src.b, uFactor), MulChannel(src.a, uFactor));
+			const uint32_t uInverse = 255 - weighted.a;
+			const auto Over = [uInverse](const uint32_t s, const uint32_t d) {
+				const uint32_t t = s + MulChannel(d, uInverse);
+				return static_cast<uint8_t>(t < 255 ? t : 255);
+			};
+			return { Over(weighted.r, dst.r), Over(weighted.g, dst.g), Over(weighted.b, dst.b), Over(weighted.a, dst.a) };
+		}
+		/// @brief Multiply the colour of a pixel by a weight as a fraction of 255, with the same arithmetic as ModulateRow()
+		inline Pixel ModulatePixel(const Pixel& pixel, const uint8_t uWeight)
+		{
+			return { MulChannel(pixel.r, uWeight), MulChannel(pixel.g, uWeight), MulChannel(pixel.b, uWeight), pixel.a };
+		}
+		/// @brief Add the colour of a pixel weighted by its alpha and w, saturating, with the same arithmetic as AddBlendRow()
+		inline Pixel AddBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			const uint32_t uWeight = MulChannel(src.a, uFactor);
+			const auto Add = [uWeight](const uint32_t s, const uint32_t d) {
+				const uint32_t t = d + MulChannel(s, uWeight);
+				return static_cast<uint8_t>(t < 255 ? t : 255);
+			};
+			return { Add(src.r, dst.r), Add(src.g, dst.g), Add(src.b, dst.b), dst.a };
+		}
+		/// @brief Multiply a pixel by the colour of another weighted by its alpha and w, with the same arithmetic as MultiplyBlendRow()
+		inline Pixel MultiplyBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			const uint32_t uWeight = MulChannel(src.a, uFactor);
+			const auto Multiply = [uWeight](const uint32_t s, const uint32_t d) {
+				return MulChannel(d, 255 - MulChannel(255 - s, uWeight));
+			};
+			return { Multiply(src.r, dst.r), Multiply(src.g, dst.g), Multiply(src.b, dst.b), dst.a };
+		}
+		/// @brief Screen a pixel with the colour of another weighted by its alpha and w, d + s * (255 - d),
+		///        with the same arithmetic as ScreenBlendRow()
+		inline Pixel ScreenBlendPixel(const Pixel& src, const Pixel& dst, const uint8_t uFactor)
+		{
+			const uint32_t uWeight = MulChannel(src.a, uFactor);
+			const auto Screen = [uWeight](const uint32_t s, const uint32_t d) {
+				return static_cast<uint8_t>(d + MulChannel(MulChannel(s, uWeight), 255 - d));
+			};
+			return { Screen(src.r, dst.r), Screen(src.g, dst.g), Screen(src.b, dst.b), dst.a };
+		}
+
+		uint8_t ToFactor(float fBlendFactor);
+		InstructionSet GetInstructionSet();
+		const char* ShowInstructionSet();
+		void AlphaBlendRow(Pixel* pDst, const Pixel* pSrc, int32_t nLength, uint8_t uFactor);
+		void PremultipliedBlendRow(Pixel* pDst, const Pixel* pSrc, int32_t nLength, uint8_t uFactor);
+		void ModulateRow(Pixel* pDst, const uint8_t* pWeights, int32_t nLength);
+		void AddBlendRow(Pixel* pDst, const Pixel* pSrc, int32_t nLength, uint8_t uFactor);
+		void MultiplyBlendRow(Pixel* pDst, const Pixel* pSrc, int32_t nLength, uint8_t uFactor);
+		void ScreenBlendRow(Pixel* pDst, const Pixel* pSrc, int32_t nLength, uint8_t uFactor);
+	}
+}
+
+#endif // G_BLEND_H
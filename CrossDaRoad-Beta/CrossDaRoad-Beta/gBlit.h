@@ -0,0 +1,444 @@
+/**
+ * @file gBlit.h
+ *
+ * @brief Contains compile-time specialized blitters
+ *
+ * This file contains the blit templates used by app::Texture, one instantiation per pixel mode, scale and
+ * source format, so these checks are resolved once per draw call instead of once per pixel.
+**/
+
+#ifndef G_BLIT_H
+#define G_BLIT_H
+
+#include "gBlend.h"
+#include "gPixel.h"
+#include "gSprite.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace app
+{
+	/// @brief Namespace for blit templates (instantiated per Pixel::Mode and scale)
+	namespace blit
+	{
+		/// @brief Clipped blit region, already resolved to raw pointers into the source and the target
+		struct Region
+		{
+			Pixel* pDst;        ///< First destination pixel (top-left of the clipped area)
+			const Pixel* pSrc;  ///< Source pixel that lands on pDst (nullptr for indexed sources)
+			const uint8_t* pSrcIndex; ///< Source palette index that lands on pDst (nullptr for RGBA sources)
+			const Pixel* pPalette;    ///< Palette of an indexed source
+			int32_t nDstPitch;  ///< Pixels per destination row
+			int32_t nSrcPitch;  ///< Pixels per source row (negative for vertically flipped blits)
+			int32_t nSrcStep;   ///< Pixels per source column (-1 for horizontally flipped blits)
+			int32_t nWidth;     ///< Clipped width, in destination pixels
+			int32_t nHeight;    ///< Clipped height, in destination pixels
+			uint32_t uScale;    ///< Scaling factor (each source pixel covers uScale x uScale destination pixels)
+			uint32_t uPhaseX;   ///< Horizontal position of pDst inside its scaled source pixel [0, uScale)
+			uint32_t uPhaseY;   ///< Vertical position of pDst inside its scaled source pixel [0, uScale)
+			uint8_t uFactor;    ///< 8-bit blend factor for Pixel::ALPHA
+			const Sprite* pSprite; ///< Source sprite, for its opaque run table (may be nullptr)
+			int32_t nSrcX;      ///< Sprite column of pSrc
+			int32_t nSrcY;      ///< Sprite row of pSrc
+		};
+
+		/// @brief Scale tags for the blit templates
+		enum Scale
+		{
+			SCALE_N = 0, ///< Any scaling factor read from Region::uScale at runtime, or a reversed source row
+			SCALE_1 = 1, ///< Unscaled and not reversed, each source row is a single span
+		};
+
+		/// @brief Read a source pixel of an RGBA sprite
+		inline Pixel Fetch(const Pixel* pSrc, const Pixel*)
+		{
+			return *pSrc;
+		}
+		/// @brief Read a source pixel of an indexed sprite, through its palette
+		inline Pixel Fetch(const uint8_t* pSrc, const Pixel* pPalette)
+		{
+			return pPalette[*pSrc];
+		}
+
+		/// @brief Source pointer of a region, for the source format Src (Pixel or uint8_t palette indices)
+		template <typename Src>
+		const Src* SourceOf(const Region& region);
+		template <>
+		inline const Pixel* SourceOf<Pixel>(const Region& region)
+		{
+			return region.pSrc;
+		}
+		template <>
+		inline const uint8_t* SourceOf<uint8_t>(const Region& region)
+		{
+			return region.pSrcIndex;
+		}
+
+		/// @brief Per-mode pixel and span operations
+		template <Pixel::Mode eMode>
+		struct Span;
+
+		/// @brief Solid copy, alpha is ignored
+		template <>
+		struct Span<Pixel::NORMAL>
+		{
+			static void Put(Pixel& dst, const Pixel src, uint8_t)
+			{
+				dst = src;
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, uint8_t)
+			{
+				std::memcpy(pDst, pSrc, nLength * sizeof(Pixel));
+			}
+		};
+
+		/// @brief Only fully opaque source pixels are copied
+		template <>
+		struct Span<Pixel::MASK>
+		{
+			static void Put(Pixel& dst, const Pixel src, uint8_t)
+			{
+				dst.n = (src.a == 255) ? src.n : dst.n;
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, uint8_t)
+			{
+				for (int32_t i = 0; i < nLength; i++) {
+					pDst[i].n = (pSrc[i].a == 255) ? pSrc[i].n : pDst[i].n;
+				}
+			}
+		};
+
+		/// @brief Only non-opaque source pixels are copied
+		template <>
+		struct Span<Pixel::BACKGROUND>
+		{
+			static void Put(Pixel& dst, const Pixel src, uint8_t)
+			{
+				dst.n = (src.a != 255) ? src.n : dst.n;
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, uint8_t)
+			{
+				for (int32_t i = 0; i < nLength; i++) {
+					pDst[i].n = (pSrc[i].a != 255) ? pSrc[i].n : pDst[i].n;
+				}
+			}
+		};
+
+		/// @brief Constant-weight blend, see kernel::AlphaBlendRow()
+		template <>
+		struct Span<Pixel::ALPHA>
+		{
+			static void Put(Pixel& dst, const Pixel src, const uint8_t uFactor)
+			{
+				dst = kernel::AlphaBlendPixel(src, dst, uFactor);
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+			{
+				kernel::AlphaBlendRow(pDst, pSrc, nLength, uFactor);
+			}
+		};
+
+		/// @brief Premultiplied source over the destination, see kernel::PremultipliedBlendRow()
+		template <>
+		struct Span<Pixel::PREMULTIPLIED>
+		{
+			static void Put(Pixel& dst, const Pixel src, const uint8_t uFactor)
+			{
+				dst = kernel::PremultipliedBlendPixel(src, dst, uFactor);
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+			{
+				kernel::PremultipliedBlendRow(pDst, pSrc, nLength, uFactor);
+			}
+		};
+
+		/// @brief Source colours added to the destination (saturating), see kernel::AddBlendRow()
+		template <>
+		struct Span<Pixel::ADD>
+		{
+			static void Put(Pixel& dst, const Pixel src, const uint8_t uFactor)
+			{
+				dst = kernel::AddBlendPixel(src, dst, uFactor);
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+			{
+				kernel::AddBlendRow(pDst, pSrc, nLength, uFactor);
+			}
+		};
+
+		/// @brief Destination multiplied by the source colours, see kernel::MultiplyBlendRow()
+		template <>
+		struct Span<Pixel::MULTIPLY>
+		{
+			static void Put(Pixel& dst, const Pixel src, const uint8_t uFactor)
+			{
+				dst = kernel::MultiplyBlendPixel(src, dst, uFactor);
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+			{
+				kernel::MultiplyBlendRow(pDst, pSrc, nLength, uFactor);
+			}
+		};
+
+		/// @brief Destination screened with the source colours, see kernel::ScreenBlendRow()
+		template <>
+		struct Span<Pixel::SCREEN>
+		{
+			static void Put(Pixel& dst, const Pixel src, const uint8_t uFactor)
+			{
+				dst = kernel::ScreenBlendPixel(src, dst, uFactor);
+			}
+			static void Run(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const uint8_t uFactor)
+			{
+				kernel::ScreenBlendRow(pDst, pSrc, nLength, uFactor);
+			}
+		};
+
+		/// @brief Scratch row for the scaled blitters, one per thread
+		/// @param nWidth Minimum number of pixels of the row
+		/// @return Pointer to at least nWidth pixels, reused across calls
+		inline Pixel* ScratchRow(const int32_t nWidth)
+		{
+			static thread_local std::vector<Pixel> vecScratch;
+			if (static_cast<int32_t>(vecScratch.size()) < nWidth) {
+				vecScratch.resize(nWidth);
+			}
+			return vecScratch.data();
+		}
+
+		/// @brief Repeat the first pixels of a row up to its end, by memcpys doubling the repeated span each time
+		/// @param pRow The row, whose first nPeriod pixels are already written
+		/// @param nPeriod Number of pixels of the repeated pattern
+		/// @param nLength Number of pixels of the row
+		inline void RepeatRow(Pixel* pRow, const int32_t nPeriod, const int32_t nLength)
+		{
+			int32_t nFilled = nPeriod;
+			while (nFilled < nLength) {
+				const int32_t nCopy = (nFilled < nLength - nFilled) ? nFilled : nLength - nFilled;
+				std::memcpy(pRow + nFilled, pRow, nCopy * sizeof(Pixel));
+				nFilled += nCopy;
+			}
+		}
+
+		/// @brief Expand a source row into a row of scaled pixels (nearest-neighbour), through the palette for indexed sources
+		/// @param pDst The expanded row, nWidth pixels
+		/// @param pSrc The source pixel that lands on pDst[0]
+		/// @param nStep Pixels to the next source pixel (-1 reverses the row)
+		/// @param nWidth Number of destination pixels to fill
+		/// @param uScale Scaling factor
+		/// @param uPhase Position of pDst[0] inside its scaled source pixel [0, uScale)
+		/// @param pPalette Palette of an indexed source
+		template <typename Src>
+		inline void ExpandRow(Pixel* pDst, const Src* pSrc, const int32_t nStep, const int32_t nWidth, const uint32_t uScale, const uint32_t uPhase, const Pixel* pPalette)
+		{
+			int32_t nRepeat = static_cast<int32_t>(uScale - uPhase);
+			int32_t nCol = 0;
+			while (nCol < nWidth) {
+				const Pixel pixel = Fetch(pSrc, pPalette);
+				pSrc += nStep;
+				const int32_t nEnd = (nCol + nRepeat < nWidth) ? nCol + nRepeat : nWidth;
+				for (; nCol < nEnd; nCol++) {
+					pDst[nCol] = pixel;
+				}
+				nRepeat = static_cast<int32_t>(uScale);
+			}
+		}
+
+		/// @brief Blit a clipped region with any scaling factor (nearest-neighbour)
+		/// @note Each source row is expanded (and reversed if flipped, and looked up if indexed) once into a scratch
+		///       row, which is then applied as a span to every destination row it covers (a plain memcpy for Pixel::NORMAL)
+		template <Pixel::Mode eMode, Scale eScale, typename Src = Pixel>
+		struct Blit
+		{
+			static void Run(const Region& region)
+			{
+				Pixel* pScratch = ScratchRow(region.nWidth);
+				Pixel* pDstRow = region.pDst;
+				const Src* pSrcRow = SourceOf<Src>(region);
+				int32_t nRepeat = static_cast<int32_t>(region.uScale - region.uPhaseY); // Rows covered by the current source row
+				int32_t nRow = 0;
+				while (nRow < region.nHeight) {
+					ExpandRow(pScratch, pSrcRow, region.nSrcStep, region.nWidth, region.uScale, region.uPhaseX, region.pPalette);
+					const int32_t nEnd = (nRow + nRepeat < region.nHeight) ? nRow + nRepeat : region.nHeight;
+					for (; nRow < nEnd; nRow++) {
+						Span<eMode>::Run(pDstRow, pScratch, region.nWidth, region.uFactor);
+						pDstRow += region.nDstPitch;
+					}
+					pSrcRow += region.nSrcPitch;
+					nRepeat = static_cast<int32_t>(region.uScale);
+				}
+			}
+		};
+
+		/// @brief Blit a clipped, unscaled region one row span at a time
+		template <Pixel::Mode eMode>
+		struct Blit<eMode, SCALE_1, Pixel>
+		{
+			static void Run(const Region& region)
+			{
+				if (region.nWidth == region.nDstPitch && region.nWidth == region.nSrcPitch) { // Contiguous rows form one span
+					Span<eMode>::Run(region.pDst, region.pSrc, region.nWidth * region.nHeight, region.uFactor);
+					return;
+				}
+				Pixel* pDst = region.pDst;
+				const Pixel* pSrc = region.pSrc;
+				for (int32_t nRow = 0; nRow < region.nHeight; nRow++) {
+					Span<eMode>::Run(pDst, pSrc, region.nWidth, region.uFactor);
+					pDst += region.nDstPitch;
+					pSrc += region.nSrcPitch;
+				}
+			}
+		};
+
+		/// @brief Copy a run of opaque source pixels
+		inline void CopyRun(Pixel* pDst, const Pixel* pSrc, const int32_t nLength, const Pixel*)
+		{
+			std::memcpy(pDst, pSrc, nLength * sizeof(Pixel));
+		}
+		/// @brief Copy a run of opaque source pixels of an indexed sprite, through its palette
+		inline void CopyRun(Pixel* pDst, const uint8_t* pSrc, const int32_t nLength, const Pixel* pPalette)
+		{
+			for (int32_t i = 0; i < nLength; i++) {
+				pDst[i] = pPalette[pSrc[i]];
+			}
+		}
+
+		/// @brief Blit a clipped, unscaled Pixel::MASK region by copying the opaque runs of the sprite,
+		///        transparent gaps are skipped without reading them
+		/// @note The region sprite must have an up-to-date opaque run table
+		template <typename Src>
+		inline void CopyOpaqueRuns(const Region& region)
+		{
+			const int32_t nLeft = region.nSrcX;
+			const int32_t nRight = region.nSrcX + region.nWidth;
+			const int32_t nStepY = region.nSrcPitch < 0 ? -1 : 1;
+			Pixel* pDstRow = region.pDst - nLeft; // Indexed by sprite column
+			const Src* pSrcRow = SourceOf<Src>(region) - nLeft;
+			for (int32_t nRow = 0; nRow < region.nHeight; nRow++) {
+				const int32_t y = region.nSrcY + nRow * nStepY;
+				const Sprite::OpaqueRun* pEnd = region.pSprite->GetOpaqueRunsEnd(y);
+				for (const Sprite::OpaqueRun* pRun = region.pSprite->GetOpaqueRunsBegin(y); pRun != pEnd; ++pRun) {
+					const int32_t nBegin = pRun->nBegin > nLeft ? pRun->nBegin : nLeft;
+					const int32_t nEnd = pRun->nEnd < nRight ? pRun->nEnd : nRight;
+					if (nBegin < nEnd) {
+						CopyRun(pDstRow + nBegin, pSrcRow + nBegin, nEnd - nBegin, region.pPalette);
+					}
+				}
+				pDstRow += region.nDstPitch;
+				pSrcRow += region.nSrcPitch;
+			}
+		}
+
+		/// @brief Blit a clipped, unscaled Pixel::MASK region of an RGBA sprite through its opaque runs
+		template <>
+		struct Blit<Pixel::MASK, SCALE_1, Pixel>
+		{
+			static void Run(const Region& region)
+			{
+				if (region.pSprite == nullptr || !region.pSprite->HasOpaqueRuns()) {
+					return RunPixels(region);
+				}
+				CopyOpaqueRuns<Pixel>(region);
+			}
+
+		private:
+			/// @brief Fallback for sprites whose pixels changed after their run table was built
+			static void RunPixels(const Region& region)
+			{
+				Pixel* pDst = region.pDst;
+				const Pixel* pSrc = region.pSrc;
+				for (int32_t nRow = 0; nRow < region.nHeight; nRow++) {
+					Span<Pixel::MASK>::Run(pDst, pSrc, region.nWidth, region.uFactor);
+					pDst += region.nDstPitch;
+					pSrc += region.nSrcPitch;
+				}
+			}
+		};
+
+		/// @brief Blit a clipped, unscaled region of an indexed sprite, each row looked up into a scratch row first
+		template <Pixel::Mode eMode>
+		struct Blit<eMode, SCALE_1, uint8_t>
+		{
+			static void Run(const Region& region)
+			{
+				Pixel* pScratch = ScratchRow(region.nWidth);
+				Pixel* pDst = region.pDst;
+				const uint8_t* pSrc = region.pSrcIndex;
+				for (int32_t nRow = 0; nRow < region.nHeight; nRow++) {
+					CopyRun(pScratch, pSrc, region.nWidth, region.pPalette);
+					Span<eMode>::Run(pDst, pScratch, region.nWidth, region.uFactor);
+					pDst += region.nDstPitch;
+					pSrc += region.nSrcPitch;
+				}
+			}
+		};
+
+		/// @brief Blit a clipped, unscaled Pixel::NORMAL region of an indexed sprite, looked up straight into the target
+		template <>
+		struct Blit<Pixel::NORMAL, SCALE_1, uint8_t>
+		{
+			static void Run(const Region& region)
+			{
+				Pixel* pDst = region.pDst;
+				const uint8_t* pSrc = region.pSrcIndex;
+				for (int32_t nRow = 0; nRow < region.nHeight; nRow++) {
+					CopyRun(pDst, pSrc, region.nWidth, region.pPalette);
+					pDst += region.nDstPitch;
+					pSrc += region.nSrcPitch;
+				}
+			}
+		};
+
+		/// @brief Blit a clipped, unscaled Pixel::MASK region of an indexed sprite through its opaque runs
+		template <>
+		struct Blit<Pixel::MASK, SCALE_1, uint8_t>
+		{
+			static void Run(const Region& region)
+			{
+				if (region.pSprite == nullptr || !region.pSprite->HasOpaqueRuns()) {
+					return Blit<Pixel::MASK, SCALE_N, uint8_t>::Run(region);
+				}
+				CopyOpaqueRuns<uint8_t>(region);
+			}
+		};
+
+		/// @brief Function pointer type of an instantiated blitter
+		typedef void (*BlitFunction)(const Region& region);
+
+		/// @brief Pick the blitter instantiated for a pixel mode, scale and source format
+		/// @param eMode The pixel mode of the draw call
+		/// @param uScale The scaling factor of the draw call
+		/// @param bReversed True if source rows are read backwards (horizontally flipped)
+		/// @param bIndexed True if the source is read through Region::pSrcIndex and Region::pPalette
+		/// @return The matching instantiation of Blit<eMode, eScale, Src>::Run
+		inline BlitFunction Select(const Pixel::Mode eMode, const uint32_t uScale, const bool bReversed = false, const bool bIndexed = false)
+		{
+			static const BlitFunction table[2][8][2] = {
+				{
+					{ &Blit<Pixel::NORMAL, SCALE_N>::Run, &Blit<Pixel::NORMAL, SCALE_1>::Run },
+					{ &Blit<Pixel::MASK, SCALE_N>::Run, &Blit<Pixel::MASK, SCALE_1>::Run },
+					{ &Blit<Pixel::ALPHA, SCALE_N>::Run, &Blit<Pixel::ALPHA, SCALE_1>::Run },
+					{ &Blit<Pixel::BACKGROUND, SCALE_N>::Run, &Blit<Pixel::BACKGROUND, SCALE_1>::Run },
+					{ &Blit<Pixel::PREMULTIPLIED, SCALE_N>::Run, &Blit<Pixel::PREMULTIPLIED, SCALE_1>::Run },
+					{ &Blit<Pixel::ADD, SCALE_N>::Run, &Blit<Pixel::ADD, SCALE_1>::Run },
+					{ &Blit<Pixel::MULTIPLY, SCALE_N>::Run, &Blit<Pixel::MULTIPLY, SCALE_1>::Run },
+					{ &Blit<Pixel::SCREEN, SCALE_N>::Run, &Blit<Pixel::SCREEN, SCALE_1>::Run },
+				},
+				{
+					{ &Blit<Pixel::NORMAL, SCALE_N, uint8_t>::Run, &Blit<Pixel::NORMAL, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::MASK, SCALE_N, uint8_t>::Run, &Blit<Pixel::MASK, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::ALPHA, SCALE_N, uint8_t>::Run, &Blit<Pixel::ALPHA, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::BACKGROUND, SCALE_N, uint8_t>::Run, &Blit<Pixel::BACKGROUND, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::PREMULTIPLIED, SCALE_N, uint8_t>::Run, &Blit<Pixel::PREMULTIPLIED, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::ADD, SCALE_N, uint8_t>::Run, &Blit<Pixel::ADD, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::MULTIPLY, SCALE_N, uint8_t>::Run, &Blit<Pixel::MULTIPLY, SCALE_1, uint8_t>::Run },
+					{ &Blit<Pixel::SCREEN, SCALE_N, uint8_t>::Run, &Blit<Pixel::SCREEN, SCALE_1, uint8_t>::Run },
+				},
+			};
+			return table[bIndexed ? 1 : 0][eMode][(uScale == 1 && !bReversed) ? SCALE_1 : SCALE_N];
+		}
+	} // namespace blit
+} // namespace app
+
+#endif // G_BLIT_H
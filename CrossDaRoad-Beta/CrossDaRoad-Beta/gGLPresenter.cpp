@@ -0,0 +1,636 @@
+/**
+ * @file gGLPresenter.cpp
+ *
+ * @brief Contains OpenGL presentation backend implementation
+ *
+ * This file implements presenting frames through OpenGL, uploading them with alternating pixel buffers
+ * and drawing them with a vertex buffer quad when the driver supports it.
+**/
+
+#include "gGLPresenter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_STATIC_DRAW 0x88E4
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_WAIT_FAILED 0x911D
+#endif
+
+namespace app
+{
+	///////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// CONSTRUCTOR AND DESTRUCTOR /////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Default constructor, uses the fastest upload path the driver supports
+	GLPresenter::GLPresenter()
+		: GLPresenter(PERSISTENT_PIXEL_BUFFER)
+	{
+	}
+	/// @brief Parameterized constructor
+	/// @param ePreferredPath Fastest upload path allowed, slower ones are used when the driver lacks it
+	GLPresenter::GLPresenter(const UploadPath ePreferredPath)
+	{
+#ifdef _WIN32
+		glDeviceContext = nullptr;
+		glRenderContext = nullptr;
+#else
+		eglDisplay = EGL_NO_DISPLAY;
+		eglSurface = EGL_NO_SURFACE;
+		eglContext = EGL_NO_CONTEXT;
+#endif
+		glBuffer = 0;
+		eUploadPath = ePreferredPath;
+		for (int i = 0; i < PIXEL_BUFFER_COUNT; i++) {
+			glPixelBuffers[i] = 0;
+			pPixelBufferData[i] = nullptr;
+			glPixelBufferFences[i] = nullptr;
+		}
+		nPixelBufferIndex = 0;
+		glQuadBuffer = 0;
+		glGenBuffers = nullptr;
+		glDeleteBuffers = nullptr;
+		glBindBuffer = nullptr;
+		glBufferData = nullptr;
+		glBufferStorage = nullptr;
+		glMapBufferRange = nullptr;
+		glUnmapBuffer = nullptr;
+		glFenceSync = nullptr;
+		glClientWaitSync = nullptr;
+		glDeleteSync = nullptr;
+	}
+	/// @brief Destructor
+	GLPresenter::~GLPresenter()
+	{
+		Destroy();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// SETUP ENVIRONMENT //////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+	/// @brief Setup the pixel format for the device context
+	/// @return True if the pixel format was setup successfully, false otherwise
+	bool GLPresenter::SetupFormatter() const
+	{
+		// Define a combination of window and OpenGL flags
+		constexpr DWORD WindowGraphicFlags = 0
+			| PFD_DRAW_TO_WINDOW   // Allow drawing to a window
+			| PFD_SUPPORT_OPENGL   // Support for OpenGL
+			| PFD_DOUBLEBUFFER     // Enable double buffering for smoother rendering
+			;
+
+		// Define a PIXELFORMATDESCRIPTOR structure with specific configuration
+		// options
+		constexpr PIXELFORMATDESCRIPTOR descriptor = {
+			sizeof(PIXELFORMATDESCRIPTOR), // Size of the structure
+			1,                             // Version number
+			WindowGraphicFlags,            // Window and OpenGL flags
+			PFD_TYPE_RGBA,                 // Pixel format is RGBA
+			32,                            // Color depth (32 bits per pixel)
+			0, 0, 0, 0,					   // Color bits ignored
+			0,							   // No alpha buffer
+			0,							   // Shift bit ignored
+			0, 0, 0, 0,					   // Accumulation buffer ignored
+			0,							   // Accumulation bits ignored
+			0, 0, 0, 0,					   // Depth and stencil buffers ignored
+			PFD_MAIN_PLANE,				   // Main layer
+			0,							   // Reserved
+			0, 0, 0						   // Layer masks ignored
+		};
+
+		// Choose a pixel format that matches the specified configuration
+		const int nPixelFormat = ChoosePixelFormat(glDeviceContext, &descriptor);
+		if (!nPixelFormat) {
+			std::cerr << "Error: Unable to choose pixel format" << std::endl;
+			return false;
+		}
+
+		// Set the chosen pixel format for rendering
+		if (!SetPixelFormat(glDeviceContext, nPixelFormat, &descriptor)) {
+			std::cerr << "Error: Unable to set pixel format" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+	/// @brief Setup rendering for the device context with the specified viewport
+	/// @param viewport The viewport state for the rendering context
+	/// @return true If rendering was setup successfully, false otherwise
+	bool GLPresenter::SetupRendering(const ViewportState& viewport)
+	{
+		// Create an OpenGL rendering context associated with the device context
+		glRenderContext = wglCreateContext(glDeviceContext);
+		if (!glRenderContext) {
+			std::cerr << "Error: Unable to create rendering context" << std::endl;
+			return false;
+		}
+
+		// Make the created rendering context current for rendering
+		if (!wglMakeCurrent(glDeviceContext, glRenderContext)) {
+			std::cerr << "Error: Unable to make rendering context current" << std::endl;
+			return false;
+		}
+
+		// Set the viewport for rendering based on the specified viewport state
+		glViewport(
+			viewport.GetX(),     // X-coordinate of the viewport's lower-left corner.
+			viewport.GetY(),     // Y-coordinate of the viewport's lower-left corner.
+			viewport.GetWidth(), // width of the viewport.
+			viewport.GetHeight() // height of the viewport.
+		);
+		return true;
+	}
+#else
+	/// @brief Setup an offscreen rendering context of the size of the viewport, works on Mesa llvmpipe without display
+	/// @param viewport The viewport state for the rendering context
+	/// @return true If rendering was setup successfully, false otherwise
+	bool GLPresenter::SetupRendering(const ViewportState& viewport)
+	{
+		// Prefer the surfaceless platform, it needs neither a display server nor a GPU
+		typedef EGLDisplay(EGLAPIENTRY eglGetPlatformDisplay_t)(EGLenum platform, void* native_display, const EGLint* attrib_list);
+		const auto eglGetPlatformDisplay = reinterpret_cast<eglGetPlatformDisplay_t*>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		constexpr EGLenum EGL_PLATFORM_SURFACELESS = 0x31DD; // EGL_PLATFORM_SURFACELESS_MESA
+		eglDisplay = eglGetPlatformDisplay ? eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+		if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr)) {
+			eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+			if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr)) {
+				std::cerr << "Error: Unable to initialize an EGL display" << std::endl;
+				return false;
+			}
+		}
+
+		// Choose an RGBA configuration rendering with desktop OpenGL on a pixel buffer surface
+		constexpr EGLint configAttributes[] = {
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+			EGL_NONE
+		};
+		EGLConfig config;
+		EGLint nConfigs = 0;
+		if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &nConfigs) || nConfigs == 0 || !eglBindAPI(EGL_OPENGL_API)) {
+			std::cerr << "Error: Unable to choose an EGL configuration" << std::endl;
+			return false;
+		}
+
+		const EGLint surfaceAttributes[] = {
+			EGL_WIDTH, viewport.GetX() + viewport.GetWidth(),
+			EGL_HEIGHT, viewport.GetY() + viewport.GetHeight(),
+			EGL_NONE
+		};
+		eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttributes);
+		eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, nullptr);
+		if (eglSurface == EGL_NO_SURFACE || eglContext == EGL_NO_CONTEXT) {
+			std::cerr << "Error: Unable to create rendering context" << std::endl;
+			return false;
+		}
+		if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+			std::cerr << "Error: Unable to make rendering context current" << std::endl;
+			return false;
+		}
+
+		SetViewport(viewport);
+		return true;
+	}
+#endif
+	/// @brief Setup texturing for the rendering context, enabling 2D texturing
+	/// @return true If texturing was setup successfully, false otherwise
+	bool GLPresenter::SetupTexturing()
+	{
+#ifdef _WIN32
+		// Get and initialize the function pointer for wglSwapInterval
+		wglSwapInterval = reinterpret_cast<wglSwapInterval_t*>(
+			wglGetProcAddress("wglSwapIntervalEXT"));
+
+		// If wglSwapInterval is available, set it to 0 to disable V-Sync
+		if (wglSwapInterval) {
+			wglSwapInterval(0);
+		}
+#endif
+
+		// Enable 2D texturing in OpenGL
+		glEnable(GL_TEXTURE_2D);
+
+		// Generate and bind a texture
+		GLuint textureID;
+		glGenTextures(1, &textureID);
+		if (textureID == 0) {
+			std::cerr << "Error: Unable to generate a texture" << std::endl;
+			return false;
+		}
+		glBuffer = textureID;
+		// Bind 2D texture with texture ID
+		glBindTexture(GL_TEXTURE_2D, // target texture, which is 2D in this case.
+			textureID      // texture ID to bind to the target.
+		);
+
+		// Set the texture magnification filter to GL_NEAREST
+		glTexParameteri(
+			GL_TEXTURE_2D,         // target texture (2D in this case).
+			GL_TEXTURE_MAG_FILTER, // parameter to set (magnification filter).
+			GL_NEAREST // filter mode, where GL_NEAREST means nearest-neighbor
+					   // filtering.
+		);
+
+		// Set the texture minification filter to GL_NEAREST
+		glTexParameteri(
+			GL_TEXTURE_2D,         // target texture (2D in this case).
+			GL_TEXTURE_MIN_FILTER, // parameter to set (minification filter).
+			GL_NEAREST // filter mode, where GL_NEAREST means nearest-neighbor
+					   // filtering.
+		);
+
+		return true;
+	}
+	/// @brief Setup the texture environment for the rendering context
+	/// @param frame The frame giving the size and the first content of the texture.
+	/// @return true If the texture environment was setup successfully, false
+	bool GLPresenter::SetupEnvironment(const Sprite& frame)
+	{
+		// Get the pixel data from the default draw target
+		const int width = frame.Width();
+		const int height = frame.Height();
+		const Pixel* target = frame.GetData();
+		if (!target) {
+			std::cerr << "Error: Unable to get valid target data" << std::endl;
+			return false;
+		}
+
+		// Set the OpenGL texture environment mode to GL_DECAL
+		glTexEnvf(
+			GL_TEXTURE_ENV, // Specifies the target texture environment to modify.
+			GL_TEXTURE_ENV_MODE, // Specifies that you're setting the texture
+			// environment mode.
+			GL_DECAL             // Set a mode (REPLACE, MODULATE, DECAL, BLEND, ADD)
+					 //     GL_DECAL means the texture replaces the object's color.
+		);
+
+		// Specify the texture image data
+		glTexImage2D(
+			GL_TEXTURE_2D, // target texture type, which is 2D in this case.
+			0,       // level of detail for the mipmap level (0 is the base level).
+			GL_RGBA, // internal format of the texture, in this case, RGBA.
+			width, height,    // width and height of the texture.
+			0,                // border width (usually set to 0).
+			GL_RGBA,          // format of the pixel data (RGBA).
+			GL_UNSIGNED_BYTE, // data type of the pixel data (unsigned bytes).
+			target            // source of the image data (the 'target' variable).
+		);
+
+		return true;
+	}
+	/// @brief Load the buffer functions, then create the pixel buffers and the quad vertex buffer
+	/// @param frame The frame giving the size of the pixel buffers
+	/// @return Always returns true, missing functions only downgrade the upload path
+	bool GLPresenter::SetupBuffers(const Sprite& frame)
+	{
+		glGenBuffers = reinterpret_cast<glGenBuffers_t*>(LoadFunction("glGenBuffers"));
+		glDeleteBuffers = reinterpret_cast<glDeleteBuffers_t*>(LoadFunction("glDeleteBuffers"));
+		glBindBuffer = reinterpret_cast<glBindBuffer_t*>(LoadFunction("glBindBuffer"));
+		glBufferData = reinterpret_cast<glBufferData_t*>(LoadFunction("glBufferData"));
+		glBufferStorage = reinterpret_cast<glBufferStorage_t*>(LoadFunction("glBufferStorage"));
+		glMapBufferRange = reinterpret_cast<glMapBufferRange_t*>(LoadFunction("glMapBufferRange"));
+		glUnmapBuffer = reinterpret_cast<glUnmapBuffer_t*>(LoadFunction("glUnmapBuffer"));
+		glFenceSync = reinterpret_cast<glFenceSync_t*>(LoadFunction("glFenceSync"));
+		glClientWaitSync = reinterpret_cast<glClientWaitSync_t*>(LoadFunction("glClientWaitSync"));
+		glDeleteSync = reinterpret_cast<glDeleteSync_t*>(LoadFunction("glDeleteSync"));
+
+		// OpenGL 1.1 only: upload from client memory and draw in immediate mode
+		if (!glGenBuffers || !glDeleteBuffers || !glBindBuffer || !glBufferData) {
+			eUploadPath = CLIENT_MEMORY;
+			return true;
+		}
+
+		// The quad never changes, its vertices (x, y, u, v) stay in a vertex buffer
+		constexpr GLfloat quad[] = {
+			-1.0f, -1.0f, 0.0f, 1.0f,
+			-1.0f, +1.0f, 0.0f, 0.0f,
+			+1.0f, +1.0f, 1.0f, 0.0f,
+			+1.0f, -1.0f, 1.0f, 1.0f,
+		};
+		glGenBuffers(1, &glQuadBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, glQuadBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glVertexPointer(2, GL_FLOAT, 4 * sizeof(GLfloat), reinterpret_cast<const void*>(0));
+		glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(GLfloat), reinterpret_cast<const void*>(2 * sizeof(GLfloat)));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// Pixel buffers hold a whole frame, so any changed rectangle fits
+		if (!glMapBufferRange || !glUnmapBuffer) {
+			eUploadPath = CLIENT_MEMORY;
+		}
+		if (!glBufferStorage || !glFenceSync || !glClientWaitSync || !glDeleteSync) {
+			eUploadPath = std::min(eUploadPath, PIXEL_BUFFER);
+		}
+		if (eUploadPath == CLIENT_MEMORY) {
+			return true;
+		}
+		const std::ptrdiff_t nBufferSize = static_cast<std::ptrdiff_t>(frame.Width()) * frame.Height() * sizeof(Pixel);
+		glGenBuffers(PIXEL_BUFFER_COUNT, glPixelBuffers);
+		for (int i = 0; i < PIXEL_BUFFER_COUNT; i++) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, glPixelBuffers[i]);
+			if (eUploadPath == PERSISTENT_PIXEL_BUFFER) {
+				constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				glBufferStorage(GL_PIXEL_UNPACK_BUFFER, nBufferSize, nullptr, flags);
+				pPixelBufferData[i] = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, nBufferSize, flags);
+				if (!pPixelBufferData[i]) {
+					std::cerr << "GLPresenter::SetupBuffers: Unable to map pixel buffer persistently" << std::endl;
+					eUploadPath = CLIENT_MEMORY;
+				}
+			}
+			else {
+				glBufferData(GL_PIXEL_UNPACK_BUFFER, nBufferSize, nullptr, GL_STREAM_DRAW);
+			}
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return true;
+	}
+	/// @brief Get the address of an OpenGL function missing from the OpenGL 1.1 exports
+	/// @param sName Name of the function
+	/// @return Address of the function, nullptr if the driver does not provide it
+	void* GLPresenter::LoadFunction(const char* sName)
+	{
+#ifdef _WIN32
+		// Some drivers return small integers instead of nullptr for missing functions
+		void* pFunction = reinterpret_cast<void*>(wglGetProcAddress(sName));
+		const intptr_t nAddress = reinterpret_cast<intptr_t>(pFunction);
+		return (nAddress >= -1 && nAddress <= 3) ? nullptr : pFunction;
+#else
+		return reinterpret_cast<void*>(eglGetProcAddress(sName));
+#endif
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////// UPDATER ///////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Set the viewport for rendering based on the specified viewport state
+	/// @param viewport Viewport state for the rendering context
+	void GLPresenter::SetViewport(const ViewportState& viewport)
+	{
+		glViewport(viewport.GetX(), viewport.GetY(), viewport.GetWidth(), viewport.GetHeight());
+	}
+	/// @brief Update a region of the texture with new image data (subimage)
+	/// @param nPitch Pixels per row of the image data (width of the texture)
+	/// @param nPosX X-coordinate of the region
+	/// @param nPosY Y-coordinate of the region
+	/// @param nWidth Width of the region
+	/// @param nHeight Height of the region
+	/// @param data Pixel data for the whole texture
+	void GLPresenter::UpdateTexture(const int nPitch, const int nPosX, const int nPosY, const int nWidth, const int nHeight, const Pixel* data)
+	{
+		if (eUploadPath != CLIENT_MEMORY && UpdateTextureFromPixelBuffer(nPitch, nPosX, nPosY, nWidth, nHeight, data)) {
+			return;
+		}
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, nPitch); // Rows of the region are nPitch pixels apart in data
+		glTexSubImage2D(GL_TEXTURE_2D, 0, nPosX, nPosY, nWidth, nHeight, GL_RGBA, GL_UNSIGNED_BYTE, data + nPosY * nPitch + nPosX);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+	/// @brief Stage a region in the next pixel buffer and upload it from there, the driver copies asynchronously
+	/// @param nPitch Pixels per row of the image data (width of the texture)
+	/// @param nPosX X-coordinate of the region
+	/// @param nPosY Y-coordinate of the region
+	/// @param nWidth Width of the region
+	/// @param nHeight Height of the region
+	/// @param data Pixel data for the whole texture
+	/// @return False if the pixel buffer could not be written, true otherwise
+	bool GLPresenter::UpdateTextureFromPixelBuffer(const int nPitch, const int nPosX, const int nPosY, const int nWidth, const int nHeight, const Pixel* data)
+	{
+		// Alternate between the buffers: this frame is written while the previous one may still upload
+		const int nIndex = nPixelBufferIndex;
+		nPixelBufferIndex = (nPixelBufferIndex + 1) % PIXEL_BUFFER_COUNT;
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, glPixelBuffers[nIndex]);
+
+		const size_t uRowBytes = static_cast<size_t>(nWidth) * sizeof(Pixel);
+		uint8_t* pStaging;
+		if (eUploadPath == PERSISTENT_PIXEL_BUFFER) {
+			// Wait for the upload issued PIXEL_BUFFER_COUNT frames ago from this buffer (usually long done)
+			if (glPixelBufferFences[nIndex]) {
+				constexpr uint64_t uTimeout = std::chrono::nanoseconds(std::chrono::seconds(1)).count();
+				glClientWaitSync(glPixelBufferFences[nIndex], GL_SYNC_FLUSH_COMMANDS_BIT, uTimeout);
+				glDeleteSync(glPixelBufferFences[nIndex]);
+				glPixelBufferFences[nIndex] = nullptr;
+			}
+			pStaging = static_cast<uint8_t*>(pPixelBufferData[nIndex]);
+		}
+		else {
+			// Invalidating lets the driver hand out fresh storage instead of waiting for the previous upload
+			constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+			pStaging = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<std::ptrdiff_t>(uRowBytes * nHeight), flags));
+		}
+		if (!pStaging) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			return false;
+		}
+
+		// Rows of the region are packed in the pixel buffer
+		for (int y = 0; y < nHeight; y++) {
+			std::memcpy(pStaging + y * uRowBytes, data + (nPosY + y) * nPitch + nPosX, uRowBytes);
+		}
+		if (eUploadPath == PIXEL_BUFFER) {
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		}
+
+		// With a pixel unpack buffer bound, the data pointer is an offset in the buffer
+		glTexSubImage2D(GL_TEXTURE_2D, 0, nPosX, nPosY, nWidth, nHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		if (eUploadPath == PERSISTENT_PIXEL_BUFFER) {
+			glPixelBufferFences[nIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return true;
+	}
+	/// @brief Display the texture on the screen
+	void GLPresenter::DrawTextureOnScreen() const
+	{
+		// The vertex and texture coordinate arrays were bound to the quad buffer by SetupBuffers()
+		if (glQuadBuffer) {
+			glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+			return;
+		}
+
+		glBegin(GL_QUADS);
+
+		// Define vertices and texture coordinates for a quadrilateral
+		glTexCoord2f(0.0, 1.0);
+		glVertex3f(-1.0f, -1.0f, 0.0f);
+		glTexCoord2f(0.0, 0.0);
+		glVertex3f(-1.0f, +1.0f, 0.0f);
+		glTexCoord2f(1.0, 0.0);
+		glVertex3f(+1.0f, +1.0f, 0.0f);
+		glTexCoord2f(1.0, 1.0);
+		glVertex3f(+1.0f, -1.0f, 0.0f);
+
+		// Finish drawing the quadrilateral
+		glEnd();
+	}
+	/// @brief Present graphics to the screen (swap buffers)
+	void GLPresenter::SwapFrame() const
+	{
+#ifdef _WIN32
+		SwapBuffers(glDeviceContext);
+#else
+		eglSwapBuffers(eglDisplay, eglSurface);
+#endif
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////// PRESENTER //////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Create the OpenGL context on the window and a texture of the size of the frame
+	/// @param pNativeWindow The window handler (HWND) of the window to draw on
+	/// @param frame The default draw target, holding the first frame
+	/// @param viewport The viewport state for the rendering context
+	/// @return True if the texture was created successfully, false otherwise
+	bool GLPresenter::Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport)
+	{
+#ifdef _WIN32
+		glDeviceContext = GetDC(static_cast<HWND>(pNativeWindow));
+		if (!glDeviceContext) {
+			std::cerr << "GLPresenter::Create: Unable to get the device context of the window" << std::endl;
+			return false;
+		}
+		if (!SetupFormatter()) {
+			std::cerr << "GLPresenter::Create: Found an error in GLPresenter::SetupFormatter()" << std::endl;
+			return false;
+		}
+#else
+		(void)pNativeWindow; // Rendering offscreen, no window is needed
+#endif
+		if (!SetupRendering(viewport)) {
+			std::cerr << "GLPresenter::Create: Found an error in GLPresenter::SetupRendering()" << std::endl;
+			return false;
+		}
+		if (!SetupTexturing()) {
+			std::cerr << "GLPresenter::Create: Found an error in GLPresenter::SetupTexturing()" << std::endl;
+			return false;
+		}
+		if (!SetupEnvironment(frame)) {
+			std::cerr << "GLPresenter::Create: Found an error in GLPresenter::SetupEnvironment()" << std::endl;
+			return false;
+		}
+		if (!SetupBuffers(frame)) {
+			std::cerr << "GLPresenter::Create: Found an error in GLPresenter::SetupBuffers()" << std::endl;
+			return false;
+		}
+		return true;
+	}
+	/// @brief Delete the buffers, the texture and the OpenGL rendering context
+	void GLPresenter::Destroy()
+	{
+		for (int i = 0; i < PIXEL_BUFFER_COUNT; i++) {
+			if (glPixelBufferFences[i]) {
+				glDeleteSync(glPixelBufferFences[i]);
+				glPixelBufferFences[i] = nullptr;
+			}
+			pPixelBufferData[i] = nullptr; // Deleting the buffer unmaps it
+		}
+		if (glPixelBuffers[0]) {
+			glDeleteBuffers(PIXEL_BUFFER_COUNT, glPixelBuffers);
+			glPixelBuffers[0] = glPixelBuffers[1] = 0;
+		}
+		if (glQuadBuffer) {
+			glDeleteBuffers(1, &glQuadBuffer);
+			glQuadBuffer = 0;
+		}
+		if (glBuffer) {
+			glDeleteTextures(1, &glBuffer);
+			glBuffer = 0;
+		}
+#ifdef _WIN32
+		if (glRenderContext) {
+			wglMakeCurrent(nullptr, nullptr);
+			wglDeleteContext(glRenderContext);
+			glRenderContext = nullptr;
+		}
+#else
+		if (eglDisplay != EGL_NO_DISPLAY) {
+			eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (eglContext != EGL_NO_CONTEXT) {
+				eglDestroyContext(eglDisplay, eglContext);
+			}
+			if (eglSurface != EGL_NO_SURFACE) {
+				eglDestroySurface(eglDisplay, eglSurface);
+			}
+			eglTerminate(eglDisplay);
+			eglDisplay = EGL_NO_DISPLAY;
+			eglSurface = EGL_NO_SURFACE;
+			eglContext = EGL_NO_CONTEXT;
+		}
+#endif
+	}
+	/// @brief Upload the changed rectangle of the frame to the texture, draw it and swap buffers
+	/// @param frame The default draw target
+	/// @param nPosX X-coordinate of the changed rectangle
+	/// @param nPosY Y-coordinate of the changed rectangle
+	/// @param nWidth Width of the changed rectangle
+	/// @param nHeight Height of the changed rectangle
+	/// @param viewport The viewport state for the rendering context
+	/// @return Always returns true by default
+	bool GLPresenter::Present(const Sprite& frame, const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight, const ViewportState& viewport)
+	{
+		// Set the viewport for rendering based on the specified viewport state
+		SetViewport(viewport);
+
+		// Update the changed region of the texture with new image data (subimage)
+		UpdateTexture(frame.Width(), nPosX, nPosY, nWidth, nHeight, frame.GetData());
+
+		// Display the texture on the screen
+		DrawTextureOnScreen();
+
+		// Present graphics to the screen (swap buffers)
+		SwapFrame();
+		return true;
+	}
+	/// @brief The WGL context lives on a native window, the EGL one on an offscreen surface
+	bool GLPresenter::NeedsWindow() const
+	{
+#ifdef _WIN32
+		return true;
+#else
+		return false;
+#endif
+	}
+	/// @brief Name of the backend
+	const char* GLPresenter::GetName() const
+	{
+		return "OpenGL";
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////// GETTERS ///////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the upload path in use, the preferred one before Create()
+	GLPresenter::UploadPath GLPresenter::GetUploadPath() const
+	{
+		return eUploadPath;
+	}
+} // namespace app
+
+///////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////// END OF FILE ////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,121 @@
+/**
+ * @file gGLPresenter.h
+ *
+ * @brief Contains OpenGL presentation backend
+ *
+ * This file contains the presentation backend showing frames through OpenGL, on a Win32 window (WGL)
+ * or on an offscreen EGL surface elsewhere.
+**/
+
+#ifndef G_GL_PRESENTER_H
+#define G_GL_PRESENTER_H
+
+#ifdef _WIN32
+#pragma comment(lib, "opengl32.lib")
+#include <Windows.h>
+#else
+#include <EGL/egl.h>
+#endif
+#include <GL/gl.h>
+#include "gPresenter.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace app
+{
+#ifdef _WIN32
+	/// @brief OpenGL function pointers for dynamic linking
+	typedef BOOL(WINAPI wglSwapInterval_t)(int interval);
+	static wglSwapInterval_t* wglSwapInterval;
+#endif
+	/// @brief OpenGL 1.5+ buffer functions, loaded at runtime since opengl32.dll only exports OpenGL 1.1
+	typedef void(APIENTRY glGenBuffers_t)(GLsizei n, GLuint* buffers);
+	typedef void(APIENTRY glDeleteBuffers_t)(GLsizei n, const GLuint* buffers);
+	typedef void(APIENTRY glBindBuffer_t)(GLenum target, GLuint buffer);
+	typedef void(APIENTRY glBufferData_t)(GLenum target, std::ptrdiff_t size, const void* data, GLenum usage);
+	typedef void(APIENTRY glBufferStorage_t)(GLenum target, std::ptrdiff_t size, const void* data, GLbitfield flags);
+	typedef void* (APIENTRY glMapBufferRange_t)(GLenum target, std::ptrdiff_t offset, std::ptrdiff_t length, GLbitfield access);
+	typedef GLboolean(APIENTRY glUnmapBuffer_t)(GLenum target);
+	typedef void* (APIENTRY glFenceSync_t)(GLenum condition, GLbitfield flags);
+	typedef GLenum(APIENTRY glClientWaitSync_t)(void* sync, GLbitfield flags, uint64_t timeout);
+	typedef void(APIENTRY glDeleteSync_t)(void* sync);
+
+	/// @brief Presentation backend uploading frames to an OpenGL texture drawn over the whole viewport
+	class GLPresenter : public Presenter
+	{
+	public:
+		/// @brief Ways of uploading the changed rectangle to the texture, fastest last
+		enum UploadPath
+		{
+			CLIENT_MEMORY,          ///< glTexSubImage2D straight from the frame, the driver copies synchronously
+			PIXEL_BUFFER,           ///< Alternating pixel buffers, mapped every frame
+			PERSISTENT_PIXEL_BUFFER ///< Alternating pixel buffers, mapped once and fenced (OpenGL 4.4)
+		};
+		static constexpr int PIXEL_BUFFER_COUNT = 2; ///< Frame N+1 is written in one while frame N uploads from the other
+
+	private: // OpenGL Environment variables
+#ifdef _WIN32
+		HDC glDeviceContext;   ///< Device context for OpenGL rendering context
+		HGLRC glRenderContext; ///< Rendering context for OpenGL
+#else
+		EGLDisplay eglDisplay; ///< EGL display (surfaceless on Mesa when available)
+		EGLSurface eglSurface; ///< Offscreen surface of the size of the viewport
+		EGLContext eglContext; ///< Rendering context for OpenGL
+#endif
+		GLuint glBuffer;       ///< OpenGL buffer for texture
+
+	private: // Buffer objects
+		UploadPath eUploadPath;                              ///< Upload path in use (the preferred one until Create())
+		GLuint glPixelBuffers[PIXEL_BUFFER_COUNT];           ///< Pixel unpack buffers the changed rectangle is staged in
+		void* pPixelBufferData[PIXEL_BUFFER_COUNT];          ///< Persistent mappings of the pixel buffers
+		void* glPixelBufferFences[PIXEL_BUFFER_COUNT];       ///< Fences of the last upload from each pixel buffer
+		int nPixelBufferIndex;                               ///< Pixel buffer staging the next frame
+		GLuint glQuadBuffer;                                 ///< Vertex buffer of the textured quad (0 for immediate mode)
+
+	private: // Buffer functions
+		glGenBuffers_t* glGenBuffers;
+		glDeleteBuffers_t* glDeleteBuffers;
+		glBindBuffer_t* glBindBuffer;
+		glBufferData_t* glBufferData;
+		glBufferStorage_t* glBufferStorage;
+		glMapBufferRange_t* glMapBufferRange;
+		glUnmapBuffer_t* glUnmapBuffer;
+		glFenceSync_t* glFenceSync;
+		glClientWaitSync_t* glClientWaitSync;
+		glDeleteSync_t* glDeleteSync;
+
+	public: // Constructors & Destructors
+		GLPresenter();
+		explicit GLPresenter(UploadPath ePreferredPath);
+		~GLPresenter() override;
+
+	private: // Setup enviroment helpers
+#ifdef _WIN32
+		bool SetupFormatter() const;
+#endif
+		bool SetupRendering(const ViewportState& viewport);
+		bool SetupTexturing();
+		static bool SetupEnvironment(const Sprite& frame);
+		bool SetupBuffers(const Sprite& frame);
+		static void* LoadFunction(const char* sName);
+
+	private: // Updater helpers
+		static void SetViewport(const ViewportState& viewport);
+		void UpdateTexture(int nPitch, int nPosX, int nPosY, int nWidth, int nHeight, const Pixel* data);
+		bool UpdateTextureFromPixelBuffer(int nPitch, int nPosX, int nPosY, int nWidth, int nHeight, const Pixel* data);
+		void DrawTextureOnScreen() const;
+		void SwapFrame() const;
+
+	public: // Presenter
+		bool Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport) override;
+		void Destroy() override;
+		bool Present(const Sprite& frame, int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight, const ViewportState& viewport) override;
+		bool NeedsWindow() const override;
+		const char* GetName() const override;
+
+	public: // Getters
+		UploadPath GetUploadPath() const;
+	};
+}
+
+#endif // G_GL_PRESENTER_H
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "gConst.h"
+#include <chrono>
 #include <iostream>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -70,6 +71,7 @@ namespace app
 		sAppName = engine::ENGINE_NAME;
 		bEngineRunning = false;
 		bEnginePausing = false;
+		uFrameLimit = 0;
 	}
 
 	/// @brief Construct the game engine with specified parameters.
@@ -110,6 +112,16 @@ namespace app
 	/// @return The result code.
 	engine::Code GameEngine::Start()
 	{
+		// Headless presenters run the engine on the calling thread, there is no message to handle.
+		if (!texture.NeedsWindow()) {
+			CreateViewport();
+			if (uFrameLimit > 0) {
+				return RunFixedFrames() ? engine::SUCCESS : engine::FAILURE;
+			}
+			HandleEngineThread();
+			return engine::SUCCESS;
+		}
+
 		// Construct the window.
 		if (!window.Create(this)) {
 			std::cerr << "Error: Failed to create the window." << std::endl;
@@ -119,6 +131,34 @@ namespace app
 		StartEngineThread();
 		return engine::SUCCESS;
 	}
+
+	/// @brief Replace the presentation backend, must be called before Start().
+	/// @param pPresenter The new presentation backend.
+	/// @return True if the presentation backend was replaced, false otherwise.
+	bool GameEngine::SetPresenter(std::unique_ptr<Presenter> pPresenter)
+	{
+		return texture.SetPresenter(std::move(pPresenter));
+	}
+
+	/// @brief Render a fixed number of frames without input instead of the interactive loop, must be called before Start().
+	/// @param uFrames The number of frames, 0 for the interactive loop.
+	/// @return True if the limit was set, false if the presentation backend needs a window.
+	bool GameEngine::SetFrameLimit(const uint32_t uFrames)
+	{
+		if (uFrames > 0 && texture.NeedsWindow()) {
+			std::cerr << "Error: A frame limit needs a headless presentation backend." << std::endl;
+			return false;
+		}
+		uFrameLimit = uFrames;
+		return true;
+	}
+
+	/// @brief Get the number of frames rendered by a headless run.
+	/// @return The frame limit, 0 for an interactive run.
+	uint32_t GameEngine::GetFrameLimit() const
+	{
+		return uFrameLimit;
+	}
 } // namespace app
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -352,12 +392,22 @@ namespace app
 	{
 		return texture.SetDefaultTargetSize(width, height);
 	}
+	/// @brief Set the sprite that draw routines render into.
+	/// @param pTarget The sprite to draw into, nullptr to draw to the screen again.
+	void GameEngine::SetDrawTarget(Sprite* pTarget)
+	{
+		texture.SetDrawTarget(pTarget);
+	}
 
 	/// @brief Draw a pixel at the specified coordinates with the given color.
 	/// @brief  - Solid color without transparency: <app::Pixel::NORMAL>
 	/// @brief  - Only draw solid color (alpha = 255): <app::Pixel::MASK>
 	/// @brief  - Fully transparent with alpha blending: <app::Pixel::ALPHA>
 	/// @brief  - Only transparency color (alpha # 255): <app::Pixel::BACKGROUND>
+	/// @brief  - Premultiplied color composited over the background: <app::Pixel::PREMULTIPLIED>
+	/// @brief  - Color added to the background (saturating): <app::Pixel::ADD>
+	/// @brief  - Background multiplied by the color: <app::Pixel::MULTIPLY>
+	/// @brief  - Background screened with the color: <app::Pixel::SCREEN>
 	///
 	/// @param x The X-coordinate.
 	/// @param y The Y-coordinate.
@@ -374,9 +424,10 @@ namespace app
 	/// @param nOffsetY The top left Y-coordinate.
 	/// @param pSprite  The sprite to draw.
 	/// @param uScale   The scaling factor (initially 1)
-	void GameEngine::DrawSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const uint32_t uScale)
+	/// @param eFlip    The mirroring applied to the sprite (initially none)
+	void GameEngine::DrawSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const uint32_t uScale, const Sprite::Flip eFlip)
 	{
-		return texture.DrawSprite(nOffsetX, nOffsetY, pSprite, uScale);
+		return texture.DrawSprite(nOffsetX, nOffsetY, pSprite, uScale, eFlip);
 	}
 
 	/// @brief Draw a scaled portion of a sprite at the specified coordinates with scaling.
@@ -388,9 +439,10 @@ namespace app
 	/// @param nWidth The width of the source area.
 	/// @param nHeight The height of the source area.
 	/// @param uScale The scaling factor to apply when drawing the sprite.
-	void GameEngine::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale)
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	void GameEngine::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale, const Sprite::Flip eFlip)
 	{
-		return texture.DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nWidth, nHeight, uScale);
+		return texture.DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nWidth, nHeight, uScale, eFlip);
 	}
 
 	/// @brief Draw partial sprite with default scaling factor, width and height.
@@ -399,17 +451,90 @@ namespace app
 	/// @param pSprite The sprite to draw.
 	/// @param nOriginX The X-coordinate of the source area (top-left corner).
 	/// @param nOriginY The Y-coordinate of the source area (top-left corner).
-	void GameEngine::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY)
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	void GameEngine::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const Sprite::Flip eFlip)
 	{
-		return texture.DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY);
+		return texture.DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, eFlip);
+	}
+
+	/// @brief Fill a rectangle with a tile of a sprite repeated in both directions.
+	/// @param nOffsetX The X-coordinate of the rectangle (top-left corner).
+	/// @param nOffsetY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @param pSprite The sprite holding the tile.
+	/// @param nOriginX The X-coordinate of the tile in the sprite (top-left corner).
+	/// @param nOriginY The Y-coordinate of the tile in the sprite (top-left corner).
+	/// @param nTileWidth The width of the tile.
+	/// @param nTileHeight The height of the tile.
+	/// @param nPhaseX The tile column drawn at nOffsetX.
+	void GameEngine::DrawTiled(const int32_t nOffsetX, const int32_t nOffsetY, const int32_t nWidth, const int32_t nHeight, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nTileWidth, const int32_t nTileHeight, const int32_t nPhaseX)
+	{
+		return texture.DrawTiled(nOffsetX, nOffsetY, nWidth, nHeight, pSprite, nOriginX, nOriginY, nTileWidth, nTileHeight, nPhaseX);
 	}
 
 	/// @brief Clear the drawing target with the specified pixel color.
 	/// @param pixel The pixel color to use for clearing.
-	void GameEngine::Clear(const Pixel pixel) const
+	void GameEngine::Clear(const Pixel pixel)
 	{
 		return texture.Clear(pixel);
 	}
+
+	/// @brief Darken a rectangle of the drawing target by per-pixel weights (lighting and visibility masks).
+	/// @param nOffsetX The X-coordinate of the rectangle (top-left corner).
+	/// @param nOffsetY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @param pWeights The weights of the rectangle, row by row (0 is black, 255 leaves the pixel unchanged).
+	/// @param nPitch The number of weights per row.
+	void GameEngine::Modulate(const int32_t nOffsetX, const int32_t nOffsetY, const int32_t nWidth, const int32_t nHeight, const uint8_t* pWeights, const int32_t nPitch)
+	{
+		return texture.Modulate(nOffsetX, nOffsetY, nWidth, nHeight, pWeights, nPitch);
+	}
+
+	/// @brief Restrict the drawing on the current target to a rectangle (intersected with the current one), until PopClipRect().
+	/// @param nPosX The X-coordinate of the rectangle (top-left corner).
+	/// @param nPosY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @return True if some part of the target can still be drawn, false otherwise.
+	bool GameEngine::PushClipRect(const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight)
+	{
+		return texture.PushClipRect(nPosX, nPosY, nWidth, nHeight);
+	}
+	/// @brief Restore the clip rectangle in use before the last PushClipRect().
+	/// @return True if a rectangle was popped, false if none was pushed.
+	bool GameEngine::PopClipRect()
+	{
+		return texture.PopClipRect();
+	}
+
+	/// @brief Start recording sprite draws on the screen, they are drawn sorted by layer then sprite by EndBatch()
+	void GameEngine::BeginBatch()
+	{
+		texture.BeginBatch();
+	}
+	/// @brief Draw the sprites recorded since BeginBatch() and stop recording
+	void GameEngine::EndBatch()
+	{
+		texture.EndBatch();
+	}
+	/// @brief Set the layer of the sprites recorded next, lower layers are drawn first
+	/// @param nLayer The layer to set
+	void GameEngine::SetDrawLayer(const int32_t nLayer)
+	{
+		texture.SetDrawLayer(nLayer);
+	}
+	/// @brief Get the layer of the sprites recorded next
+	int32_t GameEngine::GetDrawLayer() const
+	{
+		return texture.GetDrawLayer();
+	}
+	/// @brief Get the number of pixel mode changes made while drawing the last batch
+	size_t GameEngine::GetModeSwitches() const
+	{
+		return texture.GetModeSwitches();
+	}
 } // namespace app
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -455,6 +580,23 @@ namespace app
 	{
 		bEnginePausing = true;
 	}
+	/// @brief Start recording every rendered frame, encoded on a background thread
+	/// @param sFilePath Path of the recording file, played back by RecordingPlayer
+	/// @return True if the recording file was created, false otherwise.
+	bool GameEngine::StartRecording(const std::string& sFilePath)
+	{
+		return recorder.Start(sFilePath, ScreenWidth(), ScreenHeight());
+	}
+	/// @brief Stop recording, the frames still queued are encoded before the file is closed
+	void GameEngine::StopRecording()
+	{
+		recorder.Stop();
+	}
+	/// @brief Check if the rendered frames are being recorded
+	bool GameEngine::IsRecording() const
+	{
+		return recorder.IsRecording();
+	}
 } // namespace app
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -482,17 +624,36 @@ namespace app
 	/// @brief Updates rendering of the game.
 	/// @param fElapsedTime - The elapsed time since the last frame.
 	/// @return True if rendering was successful.
-	bool GameEngine::RenderTexture() const
+	bool GameEngine::RenderTexture()
 	{
+		texture.Flush();
 		texture.RenderTexture(ScreenWidth(), ScreenHeight(), viewport);
+		if (recorder.IsRecording()) { // Only a copy is made here, the encoding runs on the recorder thread
+			recorder.Capture(*texture.GetDefaultDrawTarget());
+		}
 		return true;
 	}
+	/// @brief Getter for the number of bytes uploaded to the GPU by the last rendered frame
+	/// @return Zero if nothing was drawn since the frame before
+	size_t GameEngine::GetUploadedBytes() const
+	{
+		return texture.GetUploadedBytes();
+	}
+	/// @brief Getter for the pixels written per visible pixel of the last rendered frame
+	/// @return 1.0 when every pixel was written once, above when some were drawn over
+	float GameEngine::GetOverdrawRatio() const
+	{
+		return texture.GetOverdrawRatio();
+	}
 
 	/// @brief Updates the window title suffix.
 	/// @param sTitleSuffix The suffix to append to the window title.
 	/// @return Always returns true by default.
 	bool GameEngine::UpdateWindowTitleSuffix(const std::string& sTitleSuffix)
 	{
+		if (!texture.NeedsWindow()) {
+			return true;
+		}
 		const std::string sTitle = sAppName + sTitleSuffix;
 		return window.SetTitle(sTitle);
 	}
@@ -516,8 +677,10 @@ namespace app
 	/// @return True if initialization was successful.
 	bool GameEngine::InitEngineThread()
 	{
-		CreateWindowIcon();
-		texture.CreateDeviceContext(window.GetWindowHandler());
+		if (texture.NeedsWindow()) {
+			CreateWindowIcon();
+			texture.CreateDeviceContext(window.GetWindowHandler());
+		}
 		texture.CreateTexture2D(ScreenWidth(), ScreenHeight(), viewport);
 		return true;
 	}
@@ -549,7 +712,7 @@ namespace app
 					bEngineRunning = false;           // Do not return, using break instead
 					break;                            // so we can use OnDestroyEvent()
 				}
-				UpdateWindowTitleSuffix(frame.ShowFPS());
+				UpdateWindowTitleSuffix(frame.ShowFPS() + texture.ShowOverdraw());
 				OnFixedUpdateEvent(engine::AFTER_UPDATE_TITLE_EVENT);
 				OnLateUpdateEvent(fElapsedTime, fElapsedTime + frame.GetElapsedTime(false));
 				OnFixedUpdateEvent(engine::AFTER_UPDATE_EVENT);
@@ -593,10 +756,13 @@ namespace app
 
 	/// @brief Exits the engine thread and cleans up resources.
 	/// @return True if exit was successful.
-	bool GameEngine::ExitEngineThread() const
+	bool GameEngine::ExitEngineThread()
 	{
+		recorder.Stop();
 		texture.ExitDevice();
-		window.Destroy();
+		if (texture.NeedsWindow()) {
+			window.Destroy();
+		}
 		return true;
 	}
 
@@ -610,6 +776,45 @@ namespace app
 		return true;
 	}
 
+	/// @brief Renders uFrameLimit frames as fast as possible, for benchmarks and golden-image checks.
+	///        The keyboard is never polled, nothing waits between frames, and the time given to the
+	///        application advances by one frame delay per frame, so two runs render the same frames.
+	/// @return True if every frame was rendered, false if the application stopped before.
+	bool GameEngine::RunFixedFrames()
+	{
+		InitEngineThread();
+		OnFixedUpdateEvent(0.0f, engine::BEFORE_CREATE_EVENT);
+		bEngineRunning = OnCreateEvent();
+		OnFixedUpdateEvent(0.0f, engine::AFTER_CREATE_EVENT);
+
+		const float fFrameTime = static_cast<float>(frame.GetDelay()) / 1000000.0f;
+		const auto startTime = std::chrono::steady_clock::now();
+		uint32_t uFrame = 0;
+		for (; bEngineRunning && uFrame < uFrameLimit; uFrame++) {
+			const float fTickTime = static_cast<float>(uFrame) * fFrameTime;
+			OnFixedUpdateEvent(fTickTime, engine::PRE_RUNNING_EVENT);
+			if (!OnUpdateEvent(fFrameTime)) {
+				break;
+			}
+			OnLateUpdateEvent(fFrameTime, fFrameTime);
+			if (!OnRenderEvent()) {
+				break;
+			}
+			RenderTexture();
+			OnFixedUpdateEvent(fTickTime, engine::POST_RUNNING_EVENT);
+		}
+		const float fRunTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+		std::cout << "Rendered " << uFrame << "/" << uFrameLimit << " frames in " << fRunTime * 1000.0f << " ms ("
+			<< (uFrame > 0 ? fRunTime * 1000000.0f / static_cast<float>(uFrame) : 0.0f) << " us per frame)" << std::endl;
+
+		bEngineRunning = false;
+		OnFixedUpdateEvent(fFrameTime * static_cast<float>(uFrame), engine::BEFORE_DESTROY_EVENT);
+		OnDestroyEvent();
+		OnFixedUpdateEvent(fFrameTime * static_cast<float>(uFrame), engine::AFTER_DESTROY_EVENT);
+		ExitEngineThread();
+		return uFrame == uFrameLimit;
+	}
+
 	/// @brief Starts the engine thread and message handling.
 	/// @return True if thread startup and message handling were successful.
 	bool GameEngine::StartEngineThread()
@@ -9,6 +9,7 @@
 #include "gConst.h"
 #include "gKey.h"
 #include "gPixel.h"
+#include "gRecorder.h"
 #include "gResourcePack.h"
 #include "gSprite.h"
 #include "gState.h"
@@ -38,6 +39,9 @@ namespace app
 	public: // Construction functions
 		engine::Code Construct(uint32_t screen_w, uint32_t screen_h, uint32_t pixel_w, uint32_t pixel_h, bool full_screen = false);
 		engine::Code Start();
+		bool SetPresenter(std::unique_ptr<Presenter> pPresenter);
+		bool SetFrameLimit(uint32_t uFrames);
+		uint32_t GetFrameLimit() const;
 
 	public: // Override Interfaces
 		virtual bool OnCreateEvent();
@@ -78,20 +82,35 @@ namespace app
 		void SetPixelMode(Pixel::Mode m);
 		void SetBlendFactor(float fBlend);
 		bool SetDefaultTargetSize(int32_t width, int32_t height);
+		void SetDrawTarget(Sprite* pTarget);
 		bool Draw(int32_t x, int32_t y, Pixel current_pixel = app::WHITE, uint32_t uScale = 1);
-		void DrawSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, uint32_t uScale = 1);
-		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale = 1);
-		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY);
-		void Clear(Pixel p = app::BLACK) const;
+		void DrawSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, uint32_t uScale = 1, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale = 1, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawTiled(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nTileWidth, int32_t nTileHeight, int32_t nPhaseX = 0);
+		void Clear(Pixel p = app::BLACK);
+		void Modulate(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const uint8_t* pWeights, int32_t nPitch);
+		bool PushClipRect(int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight);
+		bool PopClipRect();
+		void BeginBatch();
+		void EndBatch();
+		void SetDrawLayer(int32_t nLayer);
+		int32_t GetDrawLayer() const;
+		size_t GetModeSwitches() const;
 
 	public: // Engine Customization
 		FrameDelay GetFrameDelay() const;
 		int GetAppFPS() const;
 		bool SetFrameDelay(FrameDelay eFrameDelay);
-		bool RenderTexture() const;
+		bool RenderTexture();
+		size_t GetUploadedBytes() const;
+		float GetOverdrawRatio() const;
 		bool IsEnginePause() const;
 		void ResumeEngine();
 		void PauseEngine();
+		bool StartRecording(const std::string& sFilePath);
+		void StopRecording();
+		bool IsRecording() const;
 
 	private: // Engine Internalities
 		ScreenState screen;
@@ -99,6 +118,7 @@ namespace app
 		KeyboardState keyboard;
 		Texture texture;
 		FrameState frame;
+		Recorder recorder;
 		Window window;
 		// MouseState mouse; [unused]
 
@@ -108,10 +128,12 @@ namespace app
 		bool CreateWindowIcon();
 		bool CreateViewport();
 		bool InitEngineThread();
-		bool ExitEngineThread() const;
+		bool ExitEngineThread();
 		bool UpdateEngineEvent();
 		bool HandleEngineThread();
 		bool StartEngineThread();
+		bool RunFixedFrames();
+		uint32_t uFrameLimit; ///< Number of frames rendered by a headless run without input (0 for an interactive run)
 		// If anything sets this flag to false the engine "should" shut down gracefully
 		std::atomic<bool> bEngineRunning;
 		std::atomic<bool> bEnginePausing;
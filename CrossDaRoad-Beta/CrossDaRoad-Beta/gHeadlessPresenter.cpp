@@ -0,0 +1,233 @@
+/**
+ * @file gHeadlessPresenter.cpp
+ *
+ * @brief Contains headless presentation backend implementation
+ *
+ * This file implements presenting frames into memory, dumping them as binary PPM (P6) images and comparing them
+ * with golden images.
+**/
+
+#include "gHeadlessPresenter.h"
+#include "gUpscale.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace app
+{
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////// CONSTRUCTORS & DESTRUCTOR ///////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Default constructor, frames are kept in memory only
+	HeadlessPresenter::HeadlessPresenter()
+		: HeadlessPresenter("", 1)
+	{
+	}
+	/// @brief Parameterized constructor
+	/// @param sDumpDirectory Directory the frames are dumped to, which must exist (empty for no dumps)
+	/// @param uDumpInterval Dump every n-th presented frame
+	/// @param uScaleX Horizontal scaling factor of the dumps (app_const::PIXEL_WIDTH for the window resolution)
+	/// @param uScaleY Vertical scaling factor of the dumps (app_const::PIXEL_HEIGHT for the window resolution)
+	HeadlessPresenter::HeadlessPresenter(const std::string& sDumpDirectory, const uint32_t uDumpInterval, const uint32_t uScaleX, const uint32_t uScaleY)
+		: sDumpDirectory(sDumpDirectory), uDumpInterval(std::max(uDumpInterval, 1u)),
+		uScaleX(std::max(uScaleX, 1u)), uScaleY(std::max(uScaleY, 1u)), uFrameCount(0), uMismatchCount(0)
+	{
+	}
+	/// @brief Destructor
+	HeadlessPresenter::~HeadlessPresenter()
+	{
+		Destroy();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// PRESENTER ///////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Allocate the in-memory frame with the size and content of the default draw target
+	/// @param pNativeWindow Unused, no window is needed
+	/// @param frame The default draw target, holding the first frame
+	/// @param viewport Unused, frames are kept at their own size
+	/// @return True if the frame was allocated, false otherwise
+	bool HeadlessPresenter::Create(void*, const Sprite& frame, const ViewportState&)
+	{
+		if (frame.Width() <= 0 || frame.Height() <= 0 || frame.GetData() == nullptr) {
+			std::cerr << "HeadlessPresenter::Create: Invalid frame size" << std::endl;
+			return false;
+		}
+		pFrame.reset(new Sprite(frame.Width(), frame.Height()));
+		std::copy_n(frame.GetData(), frame.Width() * frame.Height(), pFrame->GetData());
+		if (uScaleX > 1 || uScaleY > 1) {
+			pScaledFrame.reset(new Sprite(frame.Width() * static_cast<int32_t>(uScaleX), frame.Height() * static_cast<int32_t>(uScaleY)));
+		}
+		uFrameCount = 0;
+		uMismatchCount = 0;
+		return true;
+	}
+	/// @brief Release the in-memory frames
+	void HeadlessPresenter::Destroy()
+	{
+		pFrame.reset();
+		pScaledFrame.reset();
+	}
+	/// @brief Copy the changed rectangle into the in-memory frame, then dump it and compare it with its golden image if it is due
+	/// @param frame The default draw target
+	/// @param nPosX X-coordinate of the changed rectangle
+	/// @param nPosY Y-coordinate of the changed rectangle
+	/// @param nWidth Width of the changed rectangle
+	/// @param nHeight Height of the changed rectangle
+	/// @param viewport Unused, frames are kept at their own size
+	/// @return False if Create() was not called or the dump failed, true otherwise
+	bool HeadlessPresenter::Present(const Sprite& frame, const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight, const ViewportState&)
+	{
+		if (!pFrame || pFrame->Width() != frame.Width() || pFrame->Height() != frame.Height()) {
+			std::cerr << "HeadlessPresenter::Present: Frame was not created for this draw target" << std::endl;
+			return false;
+		}
+		const int32_t nPitch = frame.Width();
+		for (int32_t y = nPosY; y < nPosY + nHeight; y++) {
+			std::copy_n(frame.GetData() + y * nPitch + nPosX, nWidth, pFrame->GetData() + y * nPitch + nPosX);
+		}
+
+		const uint64_t uFrame = uFrameCount++;
+		if ((sDumpDirectory.empty() && sGoldenDirectory.empty()) || uFrame % uDumpInterval != 0) {
+			return true;
+		}
+		const Sprite* pDumpedFrame = pFrame.get();
+		if (pScaledFrame) {
+			kernel::UpscaleSprite(*pFrame, *pScaledFrame);
+			pDumpedFrame = pScaledFrame.get();
+		}
+		if (!sGoldenDirectory.empty() && !MatchesGolden(*pDumpedFrame, uFrame)) {
+			uMismatchCount++;
+		}
+		return sDumpDirectory.empty() || SaveFramePPM(*pDumpedFrame, GetDumpPath(uFrame));
+	}
+	/// @brief No window is needed
+	bool HeadlessPresenter::NeedsWindow() const
+	{
+		return false;
+	}
+	/// @brief Name of the backend
+	const char* HeadlessPresenter::GetName() const
+	{
+		return "Headless";
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the last presented frame (nullptr before Create())
+	const Sprite* HeadlessPresenter::GetFrame() const
+	{
+		return pFrame.get();
+	}
+	/// @brief Getter for the last dumped frame at the dump resolution (nullptr if the dumps are not scaled)
+	const Sprite* HeadlessPresenter::GetScaledFrame() const
+	{
+		return pScaledFrame.get();
+	}
+	/// @brief Getter for the number of presented frames
+	uint64_t HeadlessPresenter::GetFrameCount() const
+	{
+		return uFrameCount;
+	}
+	/// @brief Getter for the dump path of a frame, "<directory>/frame_000042.ppm"
+	/// @param uFrame Index of the presented frame
+	std::string HeadlessPresenter::GetDumpPath(const uint64_t uFrame) const
+	{
+		return GetFramePath(sDumpDirectory, uFrame);
+	}
+	/// @brief Getter for the number of frames that differ from their golden image, or have none
+	uint64_t HeadlessPresenter::GetMismatchCount() const
+	{
+		return uMismatchCount;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// SETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Setter for the directory of the golden images, the frames due for a dump are compared with them
+	/// @param sDirectory Directory holding frames dumped by an earlier run, with the same interval and scale (empty for no checks)
+	void HeadlessPresenter::SetGoldenDirectory(const std::string& sDirectory)
+	{
+		sGoldenDirectory = sDirectory;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////// GOLDEN IMAGES /////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the path of a frame inside a directory, "<directory>/frame_000042.ppm"
+	/// @param sDirectory Directory of the frames
+	/// @param uFrame Index of the presented frame
+	std::string HeadlessPresenter::GetFramePath(const std::string& sDirectory, const uint64_t uFrame)
+	{
+		char sName[32];
+		std::snprintf(sName, sizeof(sName), "frame_%06llu.ppm", static_cast<unsigned long long>(uFrame));
+		return sDirectory + "/" + sName;
+	}
+	/// @brief Compare a frame with its golden image, alpha is ignored as PPM images do not store it
+	/// @param frame The frame, at the dump resolution
+	/// @param uFrame Index of the presented frame
+	/// @return True if every pixel matches, false if one differs or the golden image is missing
+	bool HeadlessPresenter::MatchesGolden(const Sprite& frame, const uint64_t uFrame) const
+	{
+		const std::string sGoldenPath = GetFramePath(sGoldenDirectory, uFrame);
+		const Sprite golden(sGoldenPath);
+		if (golden.Width() != frame.Width() || golden.Height() != frame.Height()) {
+			std::cerr << "HeadlessPresenter::MatchesGolden: Missing or resized golden image " << sGoldenPath << std::endl;
+			return false;
+		}
+		for (int32_t y = 0; y < frame.Height(); y++) {
+			const Pixel* pRow = frame.GetData() + y * frame.Width();
+			for (int32_t x = 0; x < frame.Width(); x++) {
+				const Pixel expected = golden.GetPixel(x, y);
+				if (pRow[x].r != expected.r || pRow[x].g != expected.g || pRow[x].b != expected.b) {
+					std::cerr << "HeadlessPresenter::MatchesGolden: Frame " << uFrame << " differs from " << sGoldenPath
+						<< " at (" << x << ", " << y << ")" << std::endl;
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// SAVERS /////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Save a frame as a binary PPM (P6) image, alpha is dropped
+	/// @param frame The frame to save
+	/// @param sFilePath Path of the image file
+	/// @return True if the image was written, false otherwise
+	bool HeadlessPresenter::SaveFramePPM(const Sprite& frame, const std::string& sFilePath)
+	{
+		std::ofstream ofs(sFilePath, std::ios::binary);
+		if (!ofs.is_open()) {
+			std::cerr << "HeadlessPresenter::SaveFramePPM: Unable to open " << sFilePath << std::endl;
+			return false;
+		}
+		ofs << "P6\n" << frame.Width() << " " << frame.Height() << "\n255\n";
+
+		std::vector<uint8_t> vecRow(static_cast<size_t>(frame.Width()) * 3);
+		for (int32_t y = 0; y < frame.Height(); y++) {
+			const Pixel* pRow = frame.GetData() + y * frame.Width();
+			for (int32_t x = 0; x < frame.Width(); x++) {
+				vecRow[x * 3 + 0] = pRow[x].r;
+				vecRow[x * 3 + 1] = pRow[x].g;
+				vecRow[x * 3 + 2] = pRow[x].b;
+			}
+			ofs.write(reinterpret_cast<const char*>(vecRow.data()), static_cast<std::streamsize>(vecRow.size()));
+		}
+		return ofs.good();
+	}
+} // namespace app
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// END OF FILE //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
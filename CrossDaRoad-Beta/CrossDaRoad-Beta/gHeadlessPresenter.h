@@ -0,0 +1,65 @@
+/**
+ * @file gHeadlessPresenter.h
+ *
+ * @brief Contains headless presentation backend
+ *
+ * This file contains the presentation backend keeping frames in memory, without any display or GPU.
+**/
+
+#ifndef G_HEADLESS_PRESENTER_H
+#define G_HEADLESS_PRESENTER_H
+
+#include "gPresenter.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace app
+{
+	/// @brief Presentation backend copying frames into memory, optionally dumping them as PPM images
+	///        or comparing them with golden images dumped by an earlier run
+	class HeadlessPresenter : public Presenter
+	{
+	private:
+		std::unique_ptr<Sprite> pFrame;       ///< Last presented frame
+		std::unique_ptr<Sprite> pScaledFrame; ///< Last dumped frame, upscaled to the dump resolution
+		std::string sDumpDirectory;           ///< Directory the frames are dumped to (empty for no dumps)
+		uint32_t uDumpInterval;               ///< Dump every n-th presented frame
+		uint32_t uScaleX;                     ///< Horizontal scaling factor of the dumps
+		uint32_t uScaleY;                     ///< Vertical scaling factor of the dumps
+		uint64_t uFrameCount;                 ///< Number of presented frames
+		std::string sGoldenDirectory;         ///< Directory of the expected frames to compare with (empty for no checks)
+		uint64_t uMismatchCount;              ///< Number of dumped frames that differ from their expected frame
+
+	public: // Constructors & Destructor
+		HeadlessPresenter();
+		HeadlessPresenter(const std::string& sDumpDirectory, uint32_t uDumpInterval = 1, uint32_t uScaleX = 1, uint32_t uScaleY = 1);
+		~HeadlessPresenter() override;
+
+	public: // Presenter
+		bool Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport) override;
+		void Destroy() override;
+		bool Present(const Sprite& frame, int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight, const ViewportState& viewport) override;
+		bool NeedsWindow() const override;
+		const char* GetName() const override;
+
+	public: // Getters
+		const Sprite* GetFrame() const;
+		const Sprite* GetScaledFrame() const;
+		uint64_t GetFrameCount() const;
+		std::string GetDumpPath(uint64_t uFrame) const;
+		uint64_t GetMismatchCount() const;
+
+	public: // Setters
+		void SetGoldenDirectory(const std::string& sDirectory);
+
+	private: // Golden images
+		static std::string GetFramePath(const std::string& sDirectory, uint64_t uFrame);
+		bool MatchesGolden(const Sprite& frame, uint64_t uFrame) const;
+
+	public: // Savers
+		static bool SaveFramePPM(const Sprite& frame, const std::string& sFilePath);
+	};
+}
+
+#endif // G_HEADLESS_PRESENTER_H
@@ -7,7 +7,9 @@
 **/
 
 #include "gKey.h"
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <map>
 
 namespace app
@@ -79,6 +81,7 @@ namespace app
 		return mapKeys;
 	}
 
+#ifdef _WIN32 // Virtual-key codes of the other categories come from the Win32 headers
 	/// @brief Create the map for the function key category. This contains 12 keys {
 	/// @brief     F1, F2, F3,  F4,  F5,  F6,
 	/// @brief     F7, F8, F9, F10, F11, F12
@@ -254,6 +257,7 @@ namespace app
 		mapKeys[VK_OEM_8] = Key::VENDOR;
 		return mapKeys;
 	}
+#endif // _WIN32
 
 	/// @brief Create a map of used keys. This contains 10 categories {
 	/// @brief      26 x Alphabet, 10 x Numeric, 12 x Function, 4 x Arrow, 15 x
@@ -271,6 +275,7 @@ namespace app
 		mapKeys[0x00] = NONE;
 		MergeMapKey(mapKeys, CreateMapKeyAlphabet());
 		MergeMapKey(mapKeys, CreateMapKeyNumeric());
+#ifdef _WIN32
 		MergeMapKey(mapKeys, CreateMapKeyFunction());
 		MergeMapKey(mapKeys, CreateMapKeyArrow());
 		MergeMapKey(mapKeys, CreateMapKeySpecial());
@@ -279,6 +284,7 @@ namespace app
 		MergeMapKey(mapKeys, CreateMapKeyAdditional());
 		MergeMapKey(mapKeys, CreateMapKeyMedia());
 		MergeMapKey(mapKeys, CreateMapKeyVendor());
+#endif // _WIN32
 		mapKeys[0xFF] = UNDEFINED;
 
 		return mapKeys;
@@ -10,6 +10,7 @@
 #ifndef G_KEY_H
 #define G_KEY_H
 
+#include <cstdint>
 #include <map>
 
 
@@ -186,6 +187,7 @@ namespace app
 
 	std::map<uint16_t, uint8_t> CreateMapKeyAlphabet();
 	std::map<uint16_t, uint8_t> CreateMapKeyNumeric();
+#ifdef _WIN32
 	std::map<uint16_t, uint8_t> CreateMapKeyFunction();
 	std::map<uint16_t, uint8_t> CreateMapKeyArrow();
 	std::map<uint16_t, uint8_t> CreateMapKeySpecial();
@@ -194,6 +196,7 @@ namespace app
 	std::map<uint16_t, uint8_t> CreateMapKeyAdditional();
 	std::map<uint16_t, uint8_t> CreateMapKeyMedia();
 	std::map<uint16_t, uint8_t> CreateMapKeyVendor();
+#endif // _WIN32
 	std::map<uint16_t, uint8_t> CreateMapKey();
 
 	bool IsKeyAlphabet(Key key);
@@ -7,6 +7,7 @@
 **/
 
 #include "gPixel.h"
+#include "gBlend.h"
 #include <cstdint>
 
 
@@ -52,18 +53,11 @@ namespace app
 	/// @brief Blends two pixels together
 	/// @param LHS Left hand side pixel
 	/// @param RHS Right hand side pixel
-	/// @param blendFactor The blend factor (0-255) 
+	/// @param blendFactor The blend factor (0.0-1.0), rounded to 8-bit fixed point like the row kernels
 	/// @return The blended pixel 
 	Pixel blend(const Pixel& LHS, const Pixel& RHS, const float blendFactor)
 	{
-		const float oneMinusBlendFactor = 1.0f - blendFactor;
-
-		uint8_t newR = static_cast<uint8_t>((LHS.r * blendFactor) + (RHS.r * oneMinusBlendFactor));
-		uint8_t newG = static_cast<uint8_t>((LHS.g * blendFactor) + (RHS.g * oneMinusBlendFactor));
-		uint8_t newB = static_cast<uint8_t>((LHS.b * blendFactor) + (RHS.b * oneMinusBlendFactor));
-		uint8_t newA = static_cast<uint8_t>((LHS.a * blendFactor) + (RHS.a * oneMinusBlendFactor));
-
-		return { newR, newG, newB, newA };
+		return kernel::AlphaBlendPixel(LHS, RHS, kernel::ToFactor(blendFactor));
 	}
 
 	/// @brief Friend operator for outputting pixel to stream
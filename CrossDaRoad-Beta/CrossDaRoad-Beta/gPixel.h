@@ -41,7 +41,11 @@ namespace app
                         NORMAL,    ///< Normal mode (default) - no blending is performed (alpha is ignored)
                         MASK,      ///< Mask mode - alpha is checked and if alpha is 0 then the pixel is not drawn, otherwise it is drawn fully
                         ALPHA,     ///< Alpha mode - alpha is used to blend between the pixel and the background
-                        BACKGROUND ///< Background mode - alpha is used to blend between the pixel and the background, but the alpha of the pixel is ignored
+                        BACKGROUND, ///< Background mode - alpha is used to blend between the pixel and the background, but the alpha of the pixel is ignored
+                        PREMULTIPLIED, ///< Premultiplied mode - the pixel (premultiplied by its alpha) is composited over the background, scaled by the blend factor
+                        ADD,       ///< Add mode - the pixel, weighted by its alpha and the blend factor, is added to the background (saturating)
+                        MULTIPLY,  ///< Multiply mode - the background is multiplied by the pixel, weighted by its alpha and the blend factor
+                        SCREEN     ///< Screen mode - the background is screened with the pixel (inverse multiply), weighted by its alpha and the blend factor
                 };
 
                 // Friend functions
@@ -0,0 +1,53 @@
+/**
+ * @file gPresenter.h
+ *
+ * @brief Contains presentation backend interface
+ *
+ * This file contains the interface app::Texture uses to show the default draw target (on a window, in memory, etc.).
+**/
+
+#ifndef G_PRESENTER_H
+#define G_PRESENTER_H
+
+#include "gSprite.h"
+#include "gState.h"
+#include <cstdint>
+
+namespace app
+{
+	/// @brief Interface of the backends presenting the default draw target
+	class Presenter
+	{
+	public: // Destructor
+		virtual ~Presenter() = default;
+
+	public: // Lifecycle
+		/// @brief Prepare the backend for frames of the size of the given draw target
+		/// @param pNativeWindow Native window handle (nullptr if NeedsWindow() is false)
+		/// @param frame The default draw target, holding the first frame
+		/// @param viewport The viewport the frames are shown in
+		/// @return True if the backend is ready to present, false otherwise
+		virtual bool Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport) = 0;
+		/// @brief Release everything acquired by Create()
+		virtual void Destroy() = 0;
+
+	public: // Presentation
+		/// @brief Show a frame, only the given rectangle changed since the previous one
+		/// @param frame The default draw target
+		/// @param nPosX X-coordinate of the changed rectangle
+		/// @param nPosY Y-coordinate of the changed rectangle
+		/// @param nWidth Width of the changed rectangle
+		/// @param nHeight Height of the changed rectangle
+		/// @param viewport The viewport the frame is shown in
+		/// @return True if the frame was presented, false otherwise
+		virtual bool Present(const Sprite& frame, int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight, const ViewportState& viewport) = 0;
+
+	public: // Getters
+		/// @brief Check if the backend shows frames on a native window the engine has to create
+		virtual bool NeedsWindow() const = 0;
+		/// @brief Name of the backend, for logs
+		virtual const char* GetName() const = 0;
+	};
+}
+
+#endif // G_PRESENTER_H
@@ -0,0 +1,387 @@
+/**
+ * @file gRecorder.cpp
+ *
+ * @brief Contains gameplay recorder and recording player implementation
+ *
+ * This file implements the single-producer single-consumer ring of snapshots between the engine thread
+ * and the encoder thread, and the XOR-delta run-length encoding of the frames. The engine thread only
+ * copies the frame into a free slot, a full ring drops the frame instead of waiting.
+**/
+
+#include "gRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace app
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// VARINTS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Append an unsigned integer as a varint, 7 bits per byte, lowest bits first
+	static void WriteVarint(std::vector<uint8_t>& vecOut, uint32_t uValue)
+	{
+		while (uValue >= 0x80) {
+			vecOut.push_back(static_cast<uint8_t>(uValue | 0x80));
+			uValue >>= 7;
+		}
+		vecOut.push_back(static_cast<uint8_t>(uValue));
+	}
+	/// @brief Read a varint written by WriteVarint()
+	/// @return False if the payload ends in the middle of the varint
+	static bool ReadVarint(const uint8_t*& pIn, const uint8_t* pEnd, uint32_t& uValue)
+	{
+		uValue = 0;
+		for (uint32_t uShift = 0; pIn < pEnd && uShift < 32; uShift += 7) {
+			const uint8_t uByte = *pIn++;
+			uValue |= static_cast<uint32_t>(uByte & 0x7F) << uShift;
+			if ((uByte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////// CONSTRUCTORS & DESTRUCTOR ///////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Default constructor, nothing is recorded until Start()
+	Recorder::Recorder()
+		: uPushed(0), uPopped(0), bStopping(false), uDroppedFrames(0), uEncodedBytes(0),
+		nWidth(0), nHeight(0), uKeyframeInterval(DEFAULT_KEYFRAME_INTERVAL), uEncodedFrames(0)
+	{
+	}
+	/// @brief Destructor, encodes the queued frames and closes the file
+	Recorder::~Recorder()
+	{
+		Stop();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// RECORDING ///////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Open the recording file, allocate the snapshot slots and start the encoder thread
+	/// @param sFilePath Path of the recording file
+	/// @param nWidth Width of the recorded frames
+	/// @param nHeight Height of the recorded frames
+	/// @param uKeyframeInterval Frames between two keyframes (a player can only start decoding at a keyframe)
+	/// @return False if already recording, the size is invalid or the file cannot be written, true otherwise
+	bool Recorder::Start(const std::string& sFilePath, const int32_t nWidth, const int32_t nHeight, const uint32_t uKeyframeInterval)
+	{
+		if (IsRecording()) {
+			std::cerr << "Recorder::Start: Already recording" << std::endl;
+			return false;
+		}
+		if (nWidth <= 0 || nHeight <= 0) {
+			std::cerr << "Recorder::Start: Invalid frame size" << std::endl;
+			return false;
+		}
+		ofs.open(sFilePath, std::ios::binary);
+		if (!ofs.is_open()) {
+			std::cerr << "Recorder::Start: Unable to open " << sFilePath << std::endl;
+			return false;
+		}
+
+		this->nWidth = nWidth;
+		this->nHeight = nHeight;
+		this->uKeyframeInterval = std::max(uKeyframeInterval, 1u);
+		const size_t uPixels = static_cast<size_t>(nWidth) * nHeight;
+		for (std::unique_ptr<Pixel[]>& pSlot : slots) {
+			pSlot.reset(new Pixel[uPixels]);
+			std::fill_n(pSlot.get(), uPixels, Pixel(0, 0, 0, 0)); // Fault the pages in now rather than during Capture()
+		}
+		vecPrevious.assign(uPixels, Pixel(0, 0, 0, 0));
+		vecPayload.clear();
+		vecPayload.reserve(uPixels * sizeof(Pixel));
+		uPushed = 0;
+		uPopped = 0;
+		uDroppedFrames = 0;
+		uEncodedFrames = 0;
+		bStopping = false;
+
+		const uint32_t header[5] = { recording::MAGIC, recording::VERSION, static_cast<uint32_t>(nWidth), static_cast<uint32_t>(nHeight), this->uKeyframeInterval };
+		ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+		uEncodedBytes = sizeof(header);
+		encoderThread = std::thread(&Recorder::EncodeLoop, this);
+		return true;
+	}
+	/// @brief Encode the frames still queued, then stop the encoder thread and close the file
+	void Recorder::Stop()
+	{
+		if (!encoderThread.joinable()) {
+			return;
+		}
+		bStopping = true;
+		cvWake.notify_one();
+		encoderThread.join();
+		ofs.close();
+		for (std::unique_ptr<Pixel[]>& pSlot : slots) {
+			pSlot.reset();
+		}
+	}
+	/// @brief Snapshot a frame for the encoder thread, never waits for it nor wakes it up (a wake-up can cost
+	///        more than the copy, the encoder polls every millisecond while the ring takes frames to fill)
+	/// @param frame The frame to record, of the size given to Start()
+	/// @return False if not recording, the frame has another size, or the queue is full and the frame was dropped
+	bool Recorder::Capture(const Sprite& frame)
+	{
+		if (!IsRecording() || frame.Width() != nWidth || frame.Height() != nHeight || frame.GetData() == nullptr) {
+			return false;
+		}
+		const uint64_t uSlot = uPushed.load(std::memory_order_relaxed);
+		if (uSlot - uPopped.load(std::memory_order_acquire) >= SLOT_COUNT) {
+			uDroppedFrames++;
+			return false;
+		}
+		std::memcpy(slots[uSlot % SLOT_COUNT].get(), frame.GetData(), static_cast<size_t>(nWidth) * nHeight * sizeof(Pixel));
+		uPushed.store(uSlot + 1, std::memory_order_release);
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Check if frames are being recorded
+	bool Recorder::IsRecording() const
+	{
+		return encoderThread.joinable();
+	}
+	/// @brief Getter for the number of frames handed to the encoder thread
+	uint64_t Recorder::GetCapturedFrames() const
+	{
+		return uPushed;
+	}
+	/// @brief Getter for the number of frames dropped because the encoder thread fell behind
+	uint64_t Recorder::GetDroppedFrames() const
+	{
+		return uDroppedFrames;
+	}
+	/// @brief Getter for the number of bytes written to the recording file
+	uint64_t Recorder::GetEncodedBytes() const
+	{
+		return uEncodedBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////// ENCODER THREAD /////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Body of the encoder thread: encode every queued snapshot in order, until stopped and drained
+	void Recorder::EncodeLoop()
+	{
+		while (true) {
+			const uint64_t uSlot = uPopped.load(std::memory_order_relaxed);
+			if (uSlot != uPushed.load(std::memory_order_acquire)) {
+				EncodeFrame(slots[uSlot % SLOT_COUNT].get());
+				uPopped.store(uSlot + 1, std::memory_order_release);
+				continue;
+			}
+			if (bStopping) {
+				break;
+			}
+			// Only Stop() notifies, queued snapshots are picked up by the timeout
+			std::unique_lock<std::mutex> lock(mutexWake);
+			cvWake.wait_for(lock, std::chrono::milliseconds(1), [this] {
+				return bStopping || uPopped.load(std::memory_order_relaxed) != uPushed.load(std::memory_order_acquire);
+			});
+		}
+		ofs.flush();
+	}
+	/// @brief Write a frame as runs of unchanged pixels and runs of changed pixels XORed with the previous frame
+	/// @param pFrame The snapshot to encode
+	void Recorder::EncodeFrame(const Pixel* pFrame)
+	{
+		const uint8_t uType = (uEncodedFrames % uKeyframeInterval == 0) ? recording::KEY_FRAME : recording::DELTA_FRAME;
+		if (uType == recording::KEY_FRAME) {
+			std::fill(vecPrevious.begin(), vecPrevious.end(), Pixel(0, 0, 0, 0));
+		}
+
+		vecPayload.clear();
+		const uint32_t uPixels = static_cast<uint32_t>(vecPrevious.size());
+		Pixel* pPrevious = vecPrevious.data();
+		uint32_t i = 0;
+		while (i < uPixels) {
+			const uint32_t uSameBegin = i;
+			while (i < uPixels && pFrame[i].n == pPrevious[i].n) {
+				i++;
+			}
+			const uint32_t uDiffBegin = i;
+			while (i < uPixels && pFrame[i].n != pPrevious[i].n) {
+				i++;
+			}
+			WriteVarint(vecPayload, uDiffBegin - uSameBegin);
+			WriteVarint(vecPayload, i - uDiffBegin);
+			const size_t uOffset = vecPayload.size();
+			vecPayload.resize(uOffset + (i - uDiffBegin) * sizeof(uint32_t));
+			uint8_t* pOut = vecPayload.data() + uOffset;
+			for (uint32_t j = uDiffBegin; j < i; j++, pOut += sizeof(uint32_t)) {
+				const uint32_t uXor = pFrame[j].n ^ pPrevious[j].n;
+				std::memcpy(pOut, &uXor, sizeof(uXor));
+			}
+		}
+		std::memcpy(pPrevious, pFrame, uPixels * sizeof(Pixel));
+
+		const uint32_t uSize = static_cast<uint32_t>(vecPayload.size());
+		ofs.write(reinterpret_cast<const char*>(&uType), sizeof(uType));
+		ofs.write(reinterpret_cast<const char*>(&uSize), sizeof(uSize));
+		ofs.write(reinterpret_cast<const char*>(vecPayload.data()), uSize);
+		uEncodedBytes += sizeof(uType) + sizeof(uSize) + uSize;
+		uEncodedFrames++;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	///////////////////////// PLAYER CONSTRUCTORS & DESTRUCTOR /////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Default constructor, nothing is played until Open()
+	RecordingPlayer::RecordingPlayer()
+		: uKeyframeInterval(0), uFrameIndex(0)
+	{
+	}
+	/// @brief Destructor
+	RecordingPlayer::~RecordingPlayer()
+	{
+		Close();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// PLAYBACK ///////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Open a recording and check its header, the first frame is decoded by NextFrame()
+	/// @param sFilePath Path of the recording file
+	/// @return True if the file is a recording of this version, false otherwise
+	bool RecordingPlayer::Open(const std::string& sFilePath)
+	{
+		Close();
+		ifs.open(sFilePath, std::ios::binary);
+		if (!ifs.is_open()) {
+			std::cerr << "RecordingPlayer::Open: Unable to open " << sFilePath << std::endl;
+			return false;
+		}
+		uint32_t header[5] = {};
+		ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+		if (!ifs || header[0] != recording::MAGIC || header[1] != recording::VERSION || header[2] == 0 || header[3] == 0) {
+			std::cerr << "RecordingPlayer::Open: " << sFilePath << " is not a recording" << std::endl;
+			Close();
+			return false;
+		}
+		pFrame.reset(new Sprite(static_cast<int32_t>(header[2]), static_cast<int32_t>(header[3])));
+		std::fill_n(pFrame->GetData(), pFrame->Width() * pFrame->Height(), Pixel(0, 0, 0, 0));
+		uKeyframeInterval = header[4];
+		firstFrame = ifs.tellg();
+		uFrameIndex = 0;
+		return true;
+	}
+	/// @brief Close the recording
+	void RecordingPlayer::Close()
+	{
+		if (ifs.is_open()) {
+			ifs.close();
+		}
+		pFrame.reset();
+		uFrameIndex = 0;
+	}
+	/// @brief Decode the next frame of the recording into GetFrame()
+	/// @return False at the end of the recording or if the frame is corrupted, true otherwise
+	bool RecordingPlayer::NextFrame()
+	{
+		if (!pFrame) {
+			return false;
+		}
+		uint8_t uType = 0;
+		uint32_t uSize = 0;
+		ifs.read(reinterpret_cast<char*>(&uType), sizeof(uType));
+		ifs.read(reinterpret_cast<char*>(&uSize), sizeof(uSize));
+		if (!ifs) {
+			return false;
+		}
+		vecPayload.resize(uSize);
+		ifs.read(reinterpret_cast<char*>(vecPayload.data()), uSize);
+		if (!ifs || (uType == recording::DELTA_FRAME && uFrameIndex == 0) || !DecodeFrame(uType)) {
+			std::cerr << "RecordingPlayer::NextFrame: Corrupted frame " << uFrameIndex << std::endl;
+			return false;
+		}
+		uFrameIndex++;
+		return true;
+	}
+	/// @brief Go back to the first frame of the recording
+	/// @return False if no recording is open, true otherwise
+	bool RecordingPlayer::Rewind()
+	{
+		if (!pFrame) {
+			return false;
+		}
+		ifs.clear();
+		ifs.seekg(firstFrame);
+		uFrameIndex = 0;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the last decoded frame (nullptr if no recording is open)
+	const Sprite* RecordingPlayer::GetFrame() const
+	{
+		return pFrame.get();
+	}
+	/// @brief Getter for the number of frames decoded since the first frame
+	uint64_t RecordingPlayer::GetFrameIndex() const
+	{
+		return uFrameIndex;
+	}
+	/// @brief Getter for the number of frames between two keyframes of the recording
+	uint32_t RecordingPlayer::GetKeyframeInterval() const
+	{
+		return uKeyframeInterval;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// DECODER ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Apply the payload read by NextFrame() to the last decoded frame
+	/// @param uType Type of the frame, keyframes start from a blank frame
+	/// @return False if the payload does not match the frame size, true otherwise
+	bool RecordingPlayer::DecodeFrame(const uint8_t uType)
+	{
+		Pixel* pPixels = pFrame->GetData();
+		const uint32_t uPixels = static_cast<uint32_t>(pFrame->Width() * pFrame->Height());
+		if (uType == recording::KEY_FRAME) {
+			std::fill_n(pPixels, uPixels, Pixel(0, 0, 0, 0));
+		}
+		else if (uType != recording::DELTA_FRAME) {
+			return false;
+		}
+
+		const uint8_t* pIn = vecPayload.data();
+		const uint8_t* pEnd = pIn + vecPayload.size();
+		uint32_t i = 0;
+		while (pIn < pEnd) {
+			uint32_t uSame = 0, uDiff = 0;
+			if (!ReadVarint(pIn, pEnd, uSame) || !ReadVarint(pIn, pEnd, uDiff)
+				|| uSame > uPixels - i || uDiff > uPixels - i - uSame
+				|| static_cast<size_t>(pEnd - pIn) < static_cast<size_t>(uDiff) * sizeof(uint32_t)) {
+				return false;
+			}
+			i += uSame;
+			for (uint32_t j = 0; j < uDiff; j++, i++, pIn += sizeof(uint32_t)) {
+				uint32_t uXor;
+				std::memcpy(&uXor, pIn, sizeof(uXor));
+				pPixels[i].n ^= uXor;
+			}
+		}
+		return i == uPixels;
+	}
+} // namespace app
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// END OF FILE //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,123 @@
+/**
+ * @file gRecorder.h
+ *
+ * @brief Contains gameplay recorder and recording player
+ *
+ * This file contains the recorder snapshotting presented frames for an encoder thread, which writes them
+ * as a stream of XOR deltas against the previous frame, run-length compressed, with periodic keyframes,
+ * and the player decoding such a stream back to frames.
+**/
+
+#ifndef G_RECORDER_H
+#define G_RECORDER_H
+
+#include "gPixel.h"
+#include "gSprite.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace app
+{
+	/// @brief Format of the recording files, shared by the recorder and the player
+	/// @note File: MAGIC, VERSION, width, height, keyframe interval (uint32 each), then the frames.
+	///       Frame: type (uint8), payload size (uint32), payload. The payload XORs every pixel with the
+	///       previous frame (with a black transparent frame for keyframes) as pairs of varints
+	///       (unchanged pixels, changed pixels) each followed by the changed pixels XOR values.
+	namespace recording
+	{
+		constexpr uint32_t MAGIC = 0x52524443; ///< "CDRR" read as little-endian
+		constexpr uint32_t VERSION = 1;        ///< Version of the format
+		constexpr uint8_t KEY_FRAME = 0;       ///< Frame XORed with a blank frame, decodable on its own
+		constexpr uint8_t DELTA_FRAME = 1;     ///< Frame XORed with the previous frame
+	}
+
+	/// @brief Recorder handing presented frames to an encoder thread through a bounded lock-free queue
+	class Recorder
+	{
+	public:
+		static constexpr uint32_t SLOT_COUNT = 8;                 ///< Frames queued at most, further frames are dropped
+		static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 60; ///< One keyframe per second at 60 FPS
+
+	private: // Shared
+		std::unique_ptr<Pixel[]> slots[SLOT_COUNT]; ///< Snapshots waiting for the encoder, used as a ring
+		std::atomic<uint64_t> uPushed;              ///< Snapshots written by the engine thread
+		std::atomic<uint64_t> uPopped;              ///< Snapshots encoded by the encoder thread
+		std::atomic<bool> bStopping;                ///< If the encoder thread should exit once the queue is empty
+		std::atomic<uint64_t> uDroppedFrames;       ///< Frames not recorded because the queue was full
+		std::atomic<uint64_t> uEncodedBytes;        ///< Bytes written to the file
+		std::thread encoderThread;                  ///< Thread owning the file
+		std::mutex mutexWake;                       ///< Only used to sleep on cvWake, never held by the engine thread
+		std::condition_variable cvWake;             ///< Wakes the encoder thread when the recording stops
+
+	private: // Set by Start()
+		int32_t nWidth;             ///< Width of the recorded frames
+		int32_t nHeight;            ///< Height of the recorded frames
+		uint32_t uKeyframeInterval; ///< Frames between two keyframes
+
+	private: // Encoder thread only
+		std::ofstream ofs;                  ///< Recording file
+		std::vector<Pixel> vecPrevious;     ///< Last encoded frame
+		std::vector<uint8_t> vecPayload;    ///< Encoded frame, reused across frames
+		uint64_t uEncodedFrames;            ///< Frames written to the file
+
+	public: // Constructors & Destructor
+		Recorder();
+		~Recorder();
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+	public: // Recording
+		bool Start(const std::string& sFilePath, int32_t nWidth, int32_t nHeight, uint32_t uKeyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+		void Stop();
+		bool Capture(const Sprite& frame);
+
+	public: // Getters
+		bool IsRecording() const;
+		uint64_t GetCapturedFrames() const;
+		uint64_t GetDroppedFrames() const;
+		uint64_t GetEncodedBytes() const;
+
+	private: // Encoder thread
+		void EncodeLoop();
+		void EncodeFrame(const Pixel* pFrame);
+	};
+
+	/// @brief Player decoding a recording frame by frame
+	class RecordingPlayer
+	{
+	private:
+		std::ifstream ifs;                ///< Recording file
+		std::unique_ptr<Sprite> pFrame;   ///< Last decoded frame
+		std::vector<uint8_t> vecPayload;  ///< Encoded frame, reused across frames
+		std::streampos firstFrame;        ///< File position of the first frame
+		uint32_t uKeyframeInterval;       ///< Frames between two keyframes
+		uint64_t uFrameIndex;             ///< Frames decoded since the first frame
+
+	public: // Constructors & Destructor
+		RecordingPlayer();
+		~RecordingPlayer();
+
+	public: // Playback
+		bool Open(const std::string& sFilePath);
+		void Close();
+		bool NextFrame();
+		bool Rewind();
+
+	public: // Getters
+		const Sprite* GetFrame() const;
+		uint64_t GetFrameIndex() const;
+		uint32_t GetKeyframeInterval() const;
+
+	private: // Decoder
+		bool DecodeFrame(uint8_t uType);
+	};
+}
+
+#endif // G_RECORDER_H
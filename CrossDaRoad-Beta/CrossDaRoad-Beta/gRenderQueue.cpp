@@ -0,0 +1,73 @@
+/**
+ * @file gRenderQueue.cpp
+ *
+ * @brief Contains render command buffer implementation
+ *
+ * This file implements recording and sorting of draw commands.
+**/
+
+#include "gRenderQueue.h"
+#include <algorithm>
+#include <functional>
+
+namespace app
+{
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// RECORDING ///////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Record a draw command, stamped with its recording order
+	/// @param command The command to record
+	void RenderQueue::Push(const DrawCommand& command)
+	{
+		vecCommands.push_back(command);
+		vecCommands.back().uOrder = static_cast<uint32_t>(vecCommands.size() - 1);
+	}
+	/// @brief Sort the commands by layer, then by sprite, then by recording order
+	void RenderQueue::Sort()
+	{
+		std::sort(vecCommands.begin(), vecCommands.end(), [](const DrawCommand& lhs, const DrawCommand& rhs) {
+			if (lhs.nLayer != rhs.nLayer) {
+				return lhs.nLayer < rhs.nLayer;
+			}
+			if (lhs.pSprite != rhs.pSprite) {
+				return std::less<const Sprite*>()(lhs.pSprite, rhs.pSprite);
+			}
+			return lhs.uOrder < rhs.uOrder;
+		});
+	}
+	/// @brief Drop all recorded commands
+	void RenderQueue::Clear()
+	{
+		vecCommands.clear();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Check if no command was recorded
+	bool RenderQueue::Empty() const
+	{
+		return vecCommands.empty();
+	}
+	/// @brief Getter for the number of recorded commands
+	size_t RenderQueue::Size() const
+	{
+		return vecCommands.size();
+	}
+	/// @brief Iterator to the first recorded command
+	std::vector<DrawCommand>::const_iterator RenderQueue::begin() const
+	{
+		return vecCommands.begin();
+	}
+	/// @brief Iterator past the last recorded command
+	std::vector<DrawCommand>::const_iterator RenderQueue::end() const
+	{
+		return vecCommands.end();
+	}
+} // namespace app
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// END OF FILE //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+/**
+ * @file gRenderQueue.h
+ *
+ * @brief Contains render command buffer
+ *
+ * This file contains draw commands recorded during a frame, sorted by layer then sprite before they are rasterized.
+**/
+
+#ifndef G_RENDER_QUEUE_H
+#define G_RENDER_QUEUE_H
+
+#include "gPixel.h"
+#include "gSprite.h"
+#include <cstdint>
+#include <vector>
+
+namespace app
+{
+	/// @brief Compact record of one sprite draw, replayed by Texture::Flush()
+	struct DrawCommand
+	{
+		const Sprite* pSprite; ///< Sprite to draw (must outlive the batch)
+		int32_t nOffsetX;      ///< X-coordinate for drawing
+		int32_t nOffsetY;      ///< Y-coordinate for drawing
+		int32_t nOriginX;      ///< X-coordinate of the source area
+		int32_t nOriginY;      ///< Y-coordinate of the source area
+		int32_t nWidth;        ///< Width of the source area (of the filled area for tiled draws)
+		int32_t nHeight;       ///< Height of the source area (of the filled area for tiled draws)
+		int32_t nTileWidth;    ///< Width of the repeated tile, 0 unless the draw is tiled
+		int32_t nTileHeight;   ///< Height of the repeated tile, 0 unless the draw is tiled
+		int32_t nPhaseX;       ///< Tile column drawn at nOffsetX, for tiled draws
+		uint32_t uScale;       ///< Scaling factor
+		Sprite::Flip eFlip;    ///< Mirroring applied to the sprite
+		Pixel::Mode eMode;     ///< Pixel mode at the time of recording
+		float fBlendFactor;    ///< Blend factor at the time of recording
+		int32_t nLayer;        ///< Layer, lower layers are drawn first
+		int32_t nClipLeft;     ///< Left edge of the clip rectangle at the time of recording (inclusive)
+		int32_t nClipTop;      ///< Top edge of the clip rectangle at the time of recording (inclusive)
+		int32_t nClipRight;    ///< Right edge of the clip rectangle at the time of recording (exclusive)
+		int32_t nClipBottom;   ///< Bottom edge of the clip rectangle at the time of recording (exclusive)
+		uint32_t uOrder;       ///< Recording order, keeps the sort stable
+	};
+
+	/// @brief Command buffer of the draws of one batch
+	/// @brief Draws of the same layer are grouped by sprite, so they must not overlap each other
+	class RenderQueue
+	{
+	private:
+		std::vector<DrawCommand> vecCommands; ///< Recorded commands, capacity is kept between frames
+
+	public: // Recording
+		void Push(const DrawCommand& command);
+		void Sort();
+		void Clear();
+
+	public: // Getters
+		bool Empty() const;
+		size_t Size() const;
+		std::vector<DrawCommand>::const_iterator begin() const;
+		std::vector<DrawCommand>::const_iterator end() const;
+	};
+}
+
+#endif // G_RENDER_QUEUE_H
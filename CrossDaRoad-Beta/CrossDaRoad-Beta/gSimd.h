@@ -0,0 +1,28 @@
+/**
+ * @file gSimd.h
+ *
+ * @brief Contains SIMD intrinsics setup shared by the row kernels
+ *
+ * This file detects x86 targets, includes the SSE2 and AVX2 intrinsics headers and defines per-function target
+ * attributes, so that kernels compiled for wider instruction sets can live next to the scalar ones.
+ * Only kernel translation units include it; G_SIMD_X86 is defined when the vectorized paths are available.
+**/
+
+#ifndef G_SIMD_H
+#define G_SIMD_H
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define G_SIMD_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define G_TARGET_SSE2
+#define G_TARGET_AVX2
+#else
+#define G_TARGET_SSE2 __attribute__((target("sse2")))
+#define G_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#endif // G_SIMD_H
@@ -7,17 +7,25 @@
 **/
 
 #include "gSprite.h"
+#include "gBlend.h"
 #include "gUtils.h"
 
-#include <Windows.h>
 #include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
 #include <cwchar>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#ifdef _WIN32
+#include <Windows.h>
+
 // Graphic Interface
 #pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "gdiplus.lib")
@@ -25,9 +33,11 @@
 
 #undef min
 #undef max
+#endif // _WIN32
 
 namespace app
 {
+#ifdef _WIN32
 	/// @brief Static class for GDI+ initialization and conversion from GDI+ color to Pixel color
 	static class GDIP
 	{
@@ -50,6 +60,29 @@ namespace app
 			return { pixelColor.GetRed(), pixelColor.GetGreen(), pixelColor.GetBlue(), pixelColor.GetAlpha() };
 		}
 	} gdistartup;
+#endif // _WIN32
+
+	/// @brief Read the next header token of a Netpbm image, skipping whitespace and comments
+	/// @param is Input stream positioned inside the header
+	/// @param token Token read
+	/// @return True if a token was read, false at the end of the stream
+	static bool ReadNetpbmToken(std::istream& is, std::string& token)
+	{
+		token.clear();
+		for (int c = is.get(); c != EOF; c = is.get()) {
+			if (c == '#') {
+				is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			}
+			else if (!std::isspace(c)) {
+				token.push_back(static_cast<char>(c));
+				while (!std::isspace(is.peek()) && is.peek() != EOF) {
+					token.push_back(static_cast<char>(is.get()));
+				}
+				return true;
+			}
+		}
+		return false;
+	}
 
 
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -123,8 +156,20 @@ namespace app
 	/// @param imageFilePath Image file path
 	/// @param pack Resource pack
 	/// @return engine::Code engine::SUCCESS if sprite was loaded from file, engine::FAILURE otherwise
+	/// @note PPM and PAM images are read on every platform, other formats (PNG, ...) through GDI+ on Windows only
 	engine::Code Sprite::LoadFromFile(const std::string& imageFilePath, app::ResourcePack* pack)
 	{
+		// Netpbm images need no platform library, so headless builds can load them anywhere
+		std::ifstream ifs(imageFilePath, std::ifstream::binary);
+		if (!ifs.is_open()) {
+			return engine::FILE_NOT_FOUND;
+		}
+		if (ifs.peek() == 'P') {
+			return ReadNetpbm(ifs);
+		}
+		ifs.close();
+
+#ifdef _WIN32
 		Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromFile(to_text(imageFilePath));
 		if (bitmap == nullptr) {
 			return engine::FILE_NOT_FOUND;
@@ -152,6 +197,88 @@ namespace app
 		}
 
 		delete bitmap;
+		ConvertToIndexed();
+		BuildOpaqueRuns();
+		return engine::SUCCESS;
+#else
+		std::cerr << "app::Sprite::LoadFromFile(): Only PPM and PAM images can be loaded without GDI+ (" << imageFilePath << ")" << std::endl;
+		return engine::FILE_EXTENSION_ERROR;
+#endif // _WIN32
+	}
+
+	/// @brief Reads a binary Netpbm image: PPM (P6) or PAM (P7) with RGB or RGB_ALPHA tuples
+	/// @param is The input stream to read from, positioned at the magic number
+	/// @return The error code
+	/// @retval engine::SUCCESS The image was read successfully
+	/// @retval engine::FILE_FORMAT_ERROR The header is not a supported Netpbm header
+	/// @retval engine::INVALID_SIZE The size of the image is invalid
+	/// @retval engine::FILE_READ_ERROR The pixel data could not be read from the input stream
+	/// @note Only 8-bit samples (maxval 255) are supported, PPM images are fully opaque
+	engine::Code Sprite::ReadNetpbm(std::istream& is)
+	{
+		std::string token;
+		if (!ReadNetpbmToken(is, token) || (token != "P6" && token != "P7")) {
+			return engine::FILE_FORMAT_ERROR;
+		}
+
+		int32_t nWidth = 0, nHeight = 0, nDepth = 3, nMaxValue = 0;
+		if (token == "P6") {
+			std::string sWidth, sHeight, sMaxValue;
+			if (!ReadNetpbmToken(is, sWidth) || !ReadNetpbmToken(is, sHeight) || !ReadNetpbmToken(is, sMaxValue)) {
+				return engine::FILE_FORMAT_ERROR;
+			}
+			nWidth = std::atoi(sWidth.c_str());
+			nHeight = std::atoi(sHeight.c_str());
+			nMaxValue = std::atoi(sMaxValue.c_str());
+			is.get(); // Single whitespace before the pixel data
+		}
+		else {
+			while (ReadNetpbmToken(is, token) && token != "ENDHDR") {
+				std::string sValue;
+				if (!ReadNetpbmToken(is, sValue)) {
+					return engine::FILE_FORMAT_ERROR;
+				}
+				if (token == "WIDTH") {
+					nWidth = std::atoi(sValue.c_str());
+				}
+				else if (token == "HEIGHT") {
+					nHeight = std::atoi(sValue.c_str());
+				}
+				else if (token == "DEPTH") {
+					nDepth = std::atoi(sValue.c_str());
+				}
+				else if (token == "MAXVAL") {
+					nMaxValue = std::atoi(sValue.c_str());
+				}
+			}
+			if (token != "ENDHDR") {
+				return engine::FILE_FORMAT_ERROR;
+			}
+			is.get(); // Newline ending the header
+		}
+		if (nMaxValue != 255 || (nDepth != 3 && nDepth != 4)) {
+			return engine::FILE_FORMAT_ERROR;
+		}
+		if (nWidth <= 0 || nHeight <= 0) {
+			return engine::INVALID_SIZE;
+		}
+
+		std::vector<uint8_t> vecSamples(static_cast<size_t>(nWidth) * nHeight * nDepth);
+		is.read(reinterpret_cast<char*>(vecSamples.data()), static_cast<std::streamsize>(vecSamples.size()));
+		if (is.fail()) {
+			return engine::FILE_READ_ERROR;
+		}
+
+		width = nWidth;
+		height = nHeight;
+		pColData = new Pixel[width * height];
+		for (int32_t i = 0; i < width * height; i++) {
+			const uint8_t* pSample = vecSamples.data() + static_cast<size_t>(i) * nDepth;
+			pColData[i] = Pixel(pSample[0], pSample[1], pSample[2], nDepth == 4 ? pSample[3] : 255);
+		}
+
+		ConvertToIndexed();
+		BuildOpaqueRuns();
 		return engine::SUCCESS;
 	}
 
@@ -199,6 +326,8 @@ namespace app
 			return engine::FILE_READ_ERROR;
 		}
 
+		ConvertToIndexed();
+		BuildOpaqueRuns();
 		return engine::SUCCESS;
 	}
 
@@ -234,6 +363,9 @@ namespace app
 			delete[] pColData;
 			pColData = nullptr;
 		}
+		vecIndices.clear();
+		vecPalette.clear();
+		bPremultiplied = false; // The file format stores straight alpha
 
 		std::istream inputStream(nullptr);
 		const engine::Code code = GetSpriteStream(inputStream, imageFilePath, pack);
@@ -250,6 +382,7 @@ namespace app
 	/// @retval engine::FAILURE The pixel data could not be saved
 	engine::Code Sprite::SaveSpriteFile(const std::string& imageFilePath)
 	{
+		ConvertToRGBA(); // The file format stores RGBA pixels
 		if (pColData == nullptr) {
 			return engine::FAILURE;
 		}
@@ -259,7 +392,15 @@ namespace app
 		if (ofs.is_open()) {
 			ofs.write(reinterpret_cast<char*>(&width), sizeof(int32_t));
 			ofs.write(reinterpret_cast<char*>(&height), sizeof(int32_t));
-			ofs.write(reinterpret_cast<char*>(pColData), width * height * sizeof(uint32_t));
+			if (bPremultiplied) {
+				// The file format stores straight alpha, the sprite itself stays premultiplied
+				std::vector<Pixel> vecStraight(pColData, pColData + width * height);
+				std::transform(vecStraight.begin(), vecStraight.end(), vecStraight.begin(), kernel::UnpremultiplyPixel);
+				ofs.write(reinterpret_cast<char*>(vecStraight.data()), width * height * sizeof(uint32_t));
+			}
+			else {
+				ofs.write(reinterpret_cast<char*>(pColData), width * height * sizeof(uint32_t));
+			}
 			ofs.close();
 			return engine::SUCCESS;
 		}
@@ -281,14 +422,173 @@ namespace app
 	/// @param x x-coordinate of the pixel to set
 	/// @param y y-coordinate of the pixel to set
 	/// @param p Pixel to set
+	/// @note Indexed sprites take the colour into their palette, or go back to RGBA when the palette is full
 	bool Sprite::SetPixel(const int32_t x, const int32_t y, const Pixel p)
 	{
 		if (Inside(x, y)) {
+			if (IsIndexed()) {
+				const size_t uIndex = std::find_if(vecPalette.begin(), vecPalette.end(), [p](const Pixel& q) { return q.n == p.n; }) - vecPalette.begin();
+				if (uIndex < 256) {
+					if (uIndex == vecPalette.size()) {
+						vecPalette.push_back(p);
+					}
+					vecIndices[y * width + x] = static_cast<uint8_t>(uIndex);
+					bOpaqueRunsValid = false;
+					return true;
+				}
+				ConvertToRGBA();
+			}
 			pColData[y * width + x] = p;
+			if (bOpaqueRunsValid) { // Never true on a target being rasterized in bands, see InvalidateOpaqueRuns()
+				bOpaqueRunsValid = false;
+			}
 			return true;
 		}
 		return false;
 	}
+	/// @brief Builds the per-row table of fully opaque runs, so Pixel::MASK blits can copy
+	///        opaque runs whole and skip transparent gaps without reading them, and the
+	///        columns covered by them in every row, so draws hidden below can be skipped
+	/// @note Call again after writing pixels through GetData(), SetPixel() invalidates the table by itself
+	void Sprite::BuildOpaqueRuns()
+	{
+		vecOpaqueRuns.clear();
+		vecRowRuns.assign(1, 0);
+		vecOpaqueColumns.clear();
+		if (pColData == nullptr && !IsIndexed()) {
+			bOpaqueRunsValid = false;
+			return;
+		}
+		const auto IsOpaque = [this](const int32_t nPixel) {
+			return (pColData ? pColData[nPixel] : vecPalette[vecIndices[nPixel]]).a == 255;
+		};
+		for (int32_t y = 0; y < height; y++) {
+			const int32_t nRow = y * width;
+			int32_t x = 0;
+			while (x < width) {
+				while (x < width && !IsOpaque(nRow + x)) {
+					x++;
+				}
+				const int32_t nBegin = x;
+				while (x < width && IsOpaque(nRow + x)) {
+					x++;
+				}
+				if (nBegin < x) {
+					vecOpaqueRuns.push_back({ nBegin, x });
+				}
+			}
+			vecRowRuns.push_back(static_cast<uint32_t>(vecOpaqueRuns.size()));
+		}
+
+		// A column is covered when every row has an opaque run over it
+		std::vector<int32_t> vecOpaqueRows(width, 0);
+		for (const OpaqueRun& run : vecOpaqueRuns) {
+			for (int32_t x = run.nBegin; x < run.nEnd; x++) {
+				vecOpaqueRows[x]++;
+			}
+		}
+		vecOpaqueColumns.resize(width);
+		for (int32_t x = 0; x < width; x++) {
+			vecOpaqueColumns[x] = vecOpaqueRows[x] == height;
+		}
+		bOpaqueRunsValid = true;
+	}
+	/// @brief Marks the opaque run table as out of date
+	/// @note Texture::Flush() calls it on its target before splitting it into bands, so the bands
+	///       writing pixels from several threads only ever read the flag in SetPixel()
+	void Sprite::InvalidateOpaqueRuns()
+	{
+		bOpaqueRunsValid = false;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////// PALETTE /////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Store the sprite as 8-bit indices into a palette, if it has at most 256 colours
+	/// @return True if the sprite is indexed, false if it has too many colours or no pixel
+	/// @note Indexed sprites have no GetData(), they are read through GetIndices() and GetPalette()
+	bool Sprite::ConvertToIndexed()
+	{
+		if (IsIndexed()) {
+			return true;
+		}
+		if (pColData == nullptr) {
+			return false;
+		}
+
+		std::unordered_map<uint32_t, uint8_t> mapColours;
+		std::vector<Pixel> vecColours;
+		std::vector<uint8_t> vecIndexed(static_cast<size_t>(width) * height);
+		for (size_t i = 0; i < vecIndexed.size(); i++) {
+			const auto it = mapColours.find(pColData[i].n);
+			if (it != mapColours.end()) {
+				vecIndexed[i] = it->second;
+				continue;
+			}
+			if (vecColours.size() == 256) {
+				return false;
+			}
+			vecIndexed[i] = static_cast<uint8_t>(vecColours.size());
+			mapColours.emplace(pColData[i].n, vecIndexed[i]);
+			vecColours.push_back(pColData[i]);
+		}
+
+		vecIndices = std::move(vecIndexed);
+		vecPalette = std::move(vecColours);
+		delete[] pColData;
+		pColData = nullptr;
+		return true;
+	}
+	/// @brief Store the sprite as RGBA pixels again, needed to draw on it or to write through GetData()
+	void Sprite::ConvertToRGBA()
+	{
+		if (!IsIndexed()) {
+			return;
+		}
+		pColData = new Pixel[width * height];
+		for (size_t i = 0; i < vecIndices.size(); i++) {
+			pColData[i] = vecPalette[vecIndices[i]];
+		}
+		vecIndices.clear();
+		vecIndices.shrink_to_fit();
+		vecPalette.clear();
+		vecPalette.shrink_to_fit();
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////////////////// ALPHA //////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Premultiply the colours by their alpha, once, for drawing in Pixel::PREMULTIPLIED mode
+	/// @note Fully opaque pixels are unchanged, so MASK draws of the sprite look the same
+	void Sprite::Premultiply()
+	{
+		if (bPremultiplied) {
+			return;
+		}
+		if (IsIndexed()) {
+			std::transform(vecPalette.begin(), vecPalette.end(), vecPalette.begin(), kernel::PremultiplyPixel);
+		}
+		else if (pColData) {
+			std::transform(pColData, pColData + width * height, pColData, kernel::PremultiplyPixel);
+		}
+		bPremultiplied = true;
+	}
+	/// @brief Convert the colours back to straight alpha, see kernel::UnpremultiplyPixel() for the precision
+	void Sprite::Unpremultiply()
+	{
+		if (!bPremultiplied) {
+			return;
+		}
+		if (IsIndexed()) {
+			std::transform(vecPalette.begin(), vecPalette.end(), vecPalette.begin(), kernel::UnpremultiplyPixel);
+		}
+		else if (pColData) {
+			std::transform(pColData, pColData + width * height, pColData, kernel::UnpremultiplyPixel);
+		}
+		bPremultiplied = false;
+	}
 
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////// GETTERS /////////////////////////////////////////
@@ -322,21 +622,102 @@ namespace app
 	Pixel Sprite::GetPixel(int32_t x, int32_t y) const
 	{
 		if (modeSample == app::Sprite::Mode::NORMAL) {
-			if (Inside(x, y)) {
-				return pColData[y * width + x];
+			if (!Inside(x, y)) {
+				return { 0, 0, 0, 0 };
 			}
-			return { 0, 0, 0, 0 };
 		}
-		return pColData[abs(y %= height) * width + abs(x %= width)];
+		else {
+			x = abs(x % width);
+			y = abs(y % height);
+		}
+		return pColData ? pColData[y * width + x] : vecPalette[vecIndices[y * width + x]];
 	}
 
 	/// @brief Gets the pixel data of the sprite
-	/// @return Pointer to the pixel data
+	/// @return Pointer to the pixel data, nullptr for indexed sprites (see ConvertToRGBA())
 	Pixel* Sprite::GetData() const
 	{
 		return pColData;
 	}
 
+	/// @brief Checks if the sprite is stored as palette indices
+	bool Sprite::IsIndexed() const
+	{
+		return !vecIndices.empty();
+	}
+
+	/// @brief Gets the palette indices of the sprite, row by row
+	/// @return Pointer to the indices, nullptr for RGBA sprites
+	const uint8_t* Sprite::GetIndices() const
+	{
+		return IsIndexed() ? vecIndices.data() : nullptr;
+	}
+
+	/// @brief Gets the palette of an indexed sprite
+	/// @return Pointer to GetPaletteSize() colours, nullptr for RGBA sprites
+	const Pixel* Sprite::GetPalette() const
+	{
+		return IsIndexed() ? vecPalette.data() : nullptr;
+	}
+
+	/// @brief Gets the number of colours in the palette (0 for RGBA sprites)
+	size_t Sprite::GetPaletteSize() const
+	{
+		return vecPalette.size();
+	}
+
+	/// @brief Gets the bytes used by the pixels of the sprite (indices and palette for indexed sprites)
+	size_t Sprite::GetMemoryUsage() const
+	{
+		if (IsIndexed()) {
+			return vecIndices.size() * sizeof(uint8_t) + vecPalette.size() * sizeof(Pixel);
+		}
+		return pColData ? static_cast<size_t>(width) * height * sizeof(Pixel) : 0;
+	}
+
+	/// @brief Checks if the colours are premultiplied by their alpha (see Premultiply())
+	bool Sprite::IsPremultiplied() const
+	{
+		return bPremultiplied;
+	}
+
+	/// @brief Gets the sample mode of the sprite
+	/// @return The sample mode (NORMAL or PERIODIC)
+	Sprite::Mode Sprite::GetSampleMode() const
+	{
+		return modeSample;
+	}
+
+	/// @brief Checks if the opaque run table matches the current pixels
+	bool Sprite::HasOpaqueRuns() const
+	{
+		return bOpaqueRunsValid;
+	}
+
+	/// @brief Gets the first opaque run of a row (only meaningful when HasOpaqueRuns())
+	/// @param y y-coordinate of the row
+	/// @return Pointer to the first run of the row
+	const Sprite::OpaqueRun* Sprite::GetOpaqueRunsBegin(const int32_t y) const
+	{
+		return vecOpaqueRuns.data() + vecRowRuns[y];
+	}
+
+	/// @brief Gets one past the last opaque run of a row (only meaningful when HasOpaqueRuns())
+	/// @param y y-coordinate of the row
+	/// @return Pointer past the last run of the row
+	const Sprite::OpaqueRun* Sprite::GetOpaqueRunsEnd(const int32_t y) const
+	{
+		return vecOpaqueRuns.data() + vecRowRuns[y + 1];
+	}
+
+	/// @brief Checks if a column is opaque in every row, so it hides whatever is drawn below it
+	/// @param x x-coordinate of the column
+	/// @return false if the column is outside the sprite or the opaque run table is out of date
+	bool Sprite::IsOpaqueColumn(const int32_t x) const
+	{
+		return bOpaqueRunsValid && x >= 0 && x < width && vecOpaqueColumns[x] != 0;
+	}
+
 } // namespace app
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,7 @@
 #define G_SPRITE_H
 
 #include <string>
+#include <vector>
 #include "gResourcePack.h"
 #include "gConst.h"
 
@@ -22,6 +23,7 @@ namespace app
 		int32_t width = 0;  ///< Width of the sprite
 		int32_t height = 0; ///< Height of the sprite
 
+	public:
 		/// @brief Enumeration of modes in game (for graphics)
 		enum Mode
 		{
@@ -29,10 +31,37 @@ namespace app
 			PERIODIC ///< Periodic mode - the sprite is repeated if it is drawn outside of the bounds of the sprite
 		};
 
+		/// @brief Enumeration of mirroring applied when the sprite is drawn
+		enum Flip
+		{
+			NONE = 0,       ///< Drawn as stored
+			HORIZONTAL = 1, ///< Mirrored left to right
+			VERTICAL = 2,   ///< Mirrored top to bottom
+			BOTH = 3,       ///< Mirrored on both axes (rotated by 180 degrees)
+		};
+
+		/// @brief Horizontal run of fully opaque pixels [nBegin, nEnd) inside one row
+		struct OpaqueRun
+		{
+			int32_t nBegin; ///< First opaque column of the run
+			int32_t nEnd;   ///< One past the last opaque column of the run
+		};
+
 	private:
-		Pixel* pColData = nullptr;      ///< Pointer to the pixel data
+		Pixel* pColData = nullptr;      ///< Pointer to the pixel data (nullptr for indexed sprites)
 		Mode modeSample = Mode::NORMAL; ///< Mode for sampling outside the bounds of the sprite (default is NORMAL)
 
+	private: // Indexed storage (for sprites of at most 256 colours)
+		std::vector<uint8_t> vecIndices; ///< Palette index of every pixel, row by row (empty for RGBA sprites)
+		std::vector<Pixel> vecPalette;   ///< Colours the indices refer to
+		bool bPremultiplied = false;     ///< True if the colours are premultiplied by their alpha
+
+	private: // Opaque run table (for Pixel::MASK blits)
+		std::vector<OpaqueRun> vecOpaqueRuns; ///< Opaque runs of all rows, row by row
+		std::vector<uint32_t> vecRowRuns;     ///< Runs of row y are vecOpaqueRuns[vecRowRuns[y] .. vecRowRuns[y + 1])
+		std::vector<uint8_t> vecOpaqueColumns; ///< Non-zero for columns that are opaque in every row
+		bool bOpaqueRunsValid = false;        ///< False once pixels changed after the table was built
+
 	public: // Constructors & Destructor
 		Sprite();
 		Sprite(const std::string& sImageFile);
@@ -42,6 +71,7 @@ namespace app
 
 	private: // Loaders & Savers
 		engine::Code ReadData(std::istream& is);
+		engine::Code ReadNetpbm(std::istream& is);
 		engine::Code LoadFromFile(const std::string& s_image_file, app::ResourcePack* pack = nullptr);
 		static engine::Code GetSpriteStream(std::istream& stream, const std::string& sImageFile, app::ResourcePack* pack);
 		engine::Code LoadSpriteFile(const std::string& sImageFile, app::ResourcePack* pack = nullptr);
@@ -50,6 +80,16 @@ namespace app
 	public: // Setters
 		void SetSampleMode(app::Sprite::Mode mode = app::Sprite::Mode::NORMAL);
 		bool SetPixel(int32_t x, int32_t y, Pixel p);
+		void BuildOpaqueRuns();
+		void InvalidateOpaqueRuns();
+
+	public: // Palette
+		bool ConvertToIndexed();
+		void ConvertToRGBA();
+
+	public: // Alpha
+		void Premultiply();
+		void Unpremultiply();
 
 	public: // Getters
 		bool Inside(int32_t x, int32_t y) const;
@@ -57,6 +97,17 @@ namespace app
 		int32_t Height() const;
 		Pixel GetPixel(int32_t x, int32_t y) const;
 		Pixel* GetData() const;
+		bool IsIndexed() const;
+		const uint8_t* GetIndices() const;
+		const Pixel* GetPalette() const;
+		size_t GetPaletteSize() const;
+		size_t GetMemoryUsage() const;
+		bool IsPremultiplied() const;
+		Mode GetSampleMode() const;
+		bool HasOpaqueRuns() const;
+		const OpaqueRun* GetOpaqueRunsBegin(int32_t y) const;
+		const OpaqueRun* GetOpaqueRunsEnd(int32_t y) const;
+		bool IsOpaqueColumn(int32_t x) const;
 	};
 }
 
@@ -6,6 +6,7 @@
  * This file implements button enumeration, state of button, screen, viewport, frame, keyboard, and mouse for game state management.
 **/
 #include "gState.h"
+#include <cmath>
 
 //===========================================================================================
 //========================= SCREEN STATE ====================================================
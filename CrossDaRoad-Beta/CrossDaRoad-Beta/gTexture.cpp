@@ -7,6 +7,16 @@
  **/
 
 #include "gTexture.h"
+#include "gBlit.h"
+#include "gBlend.h"
+#include "gHeadlessPresenter.h"
+#include "gThreadedPresenter.h"
+#ifdef _WIN32
+#include "gGLPresenter.h"
+#endif
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 
 
@@ -22,11 +32,11 @@ namespace app
 		InitDevice();
 	}
 	/// @brief Parameterized constructor
-	/// @param windowHandler The window handler for the window to draw on
-	Texture::Texture(const HWND windowHandler)
+	/// @param pWindow The native window handle of the window to draw on
+	Texture::Texture(void* pWindow)
 	{
 		InitDevice();
-		CreateDeviceContext(windowHandler);
+		CreateDeviceContext(pWindow);
 	}
 	/// @brief Destructor
 	Texture::~Texture()
@@ -42,273 +52,307 @@ namespace app
 		pDrawTarget = nullptr;
 		nPixelMode = Pixel::NORMAL;
 		fBlendFactor = 1.0f;
+		uBlendFactor = 255;
 		nDefaultWidth = 0;
 		nDefaultHeight = 0;
+		uUploadedBytes = 0;
+		ClearDirty();
+		uPixelsWritten = 0;
+		uFramePixelsWritten = 0;
+		bBatching = false;
+		nDrawLayer = 0;
+		uModeSwitches = 0;
+		nBandHeight = 16;
 
-		glDeviceContext = nullptr;
-		glRenderContext = nullptr;
-		glBuffer = 0;
+		pNativeWindow = nullptr;
+#ifdef _WIN32
+		// Uploads and buffer swaps run on a render thread, the engine thread never waits for them
+		pPresenter.reset(new ThreadedPresenter(std::unique_ptr<Presenter>(new GLPresenter())));
+#else
+		pPresenter.reset(new HeadlessPresenter());
+#endif
 		return true;
 	}
-	/// @brief Create the device context for the window to draw on
-	/// @param windowHandler  The window handler for the window to draw on
-	/// @return True if the device context was created successfully, false otherwise
-	bool Texture::CreateDeviceContext(const HWND windowHandler)
+	/// @brief Remember the window to draw on, for presenters that need one
+	/// @param pWindow The native window handle of the window to draw on
+	/// @return True if the window handle is usable, false otherwise
+	bool Texture::CreateDeviceContext(void* pWindow)
 	{
-		glDeviceContext = GetDC(windowHandler);
-		return glDeviceContext != nullptr;
+		pNativeWindow = pWindow;
+		return pNativeWindow != nullptr || !NeedsWindow();
 	}
 	/// @brief Exit the device context, releasing all resources
 	/// @return Always returns true by default
 	bool Texture::ExitDevice() const
 	{
-		wglDeleteContext(glRenderContext);
+		if (pPresenter) {
+			pPresenter->Destroy();
+		}
 		return true;
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////
-	////////////////////////////////// SETUP ENVIRONMENT //////////////////////////////////
+	////////////////////////////////////// PRESENTER //////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////////
 
-	/// @brief Setup the pixel format for the device context
-	/// @return True if the pixel format was setup successfully, false otherwise
-	bool Texture::SetupFormatter() const
-	{
-		// Define a combination of window and OpenGL flags
-		constexpr DWORD WindowGraphicFlags = 0
-			| PFD_DRAW_TO_WINDOW   // Allow drawing to a window
-			| PFD_SUPPORT_OPENGL   // Support for OpenGL
-			| PFD_DOUBLEBUFFER     // Enable double buffering for smoother rendering
-			;
-
-		// Define a PIXELFORMATDESCRIPTOR structure with specific configuration
-		// options
-		constexpr PIXELFORMATDESCRIPTOR descriptor = {
-			sizeof(PIXELFORMATDESCRIPTOR), // Size of the structure
-			1,                             // Version number
-			WindowGraphicFlags,            // Window and OpenGL flags
-			PFD_TYPE_RGBA,                 // Pixel format is RGBA
-			32,                            // Color depth (32 bits per pixel)
-			0, 0, 0, 0,					   // Color bits ignored
-			0,							   // No alpha buffer
-			0,							   // Shift bit ignored
-			0, 0, 0, 0,					   // Accumulation buffer ignored
-			0,							   // Accumulation bits ignored
-			0, 0, 0, 0,					   // Depth and stencil buffers ignored
-			PFD_MAIN_PLANE,				   // Main layer
-			0,							   // Reserved
-			0, 0, 0						   // Layer masks ignored
-		};
-
-		// Choose a pixel format that matches the specified configuration
-		const int nPixelFormat = ChoosePixelFormat(glDeviceContext, &descriptor);
-		if (!nPixelFormat) {
-			std::cerr << "Error: Unable to choose pixel format" << std::endl;
+	/// @brief Replace the presentation backend, before CreateTexture2D()
+	/// @param presenter The backend to present frames with
+	/// @return True if the backend was set, false if it is null
+	bool Texture::SetPresenter(std::unique_ptr<Presenter> presenter)
+	{
+		if (!presenter) {
+			std::cerr << "Error: Presenter is not set." << std::endl;
 			return false;
 		}
-
-		// Set the chosen pixel format for rendering
-		if (!SetPixelFormat(glDeviceContext, nPixelFormat, &descriptor)) {
-			std::cerr << "Error: Unable to set pixel format" << std::endl;
-			return false;
+		if (pPresenter) {
+			pPresenter->Destroy();
 		}
-
+		pPresenter = std::move(presenter);
 		return true;
 	}
-	/// @brief Setup rendering for the device context with the specified viewport
-	/// @param viewport The viewport state for the rendering context
-	/// @return true If rendering was setup successfully, false otherwise
-	bool Texture::SetupRendering(const ViewportState viewport)
+	/// @brief Getter for the presentation backend
+	Presenter* Texture::GetPresenter() const
 	{
-		// Create an OpenGL rendering context associated with the device context
-		glRenderContext = wglCreateContext(glDeviceContext);
-		if (!glRenderContext) {
-			std::cerr << "Error: Unable to create rendering context" << std::endl;
-			return false;
-		}
-
-		// Make the created rendering context current for rendering
-		if (!wglMakeCurrent(glDeviceContext, glRenderContext)) {
-			std::cerr << "Error: Unable to make rendering context current" << std::endl;
-			return false;
-		}
-
-		// Set the viewport for rendering based on the specified viewport state
-		glViewport(
-			viewport.GetX(),     // X-coordinate of the viewport's lower-left corner.
-			viewport.GetY(),     // Y-coordinate of the viewport's lower-left corner.
-			viewport.GetWidth(), // width of the viewport.
-			viewport.GetHeight() // height of the viewport.
-		);
-		return true;
+		return pPresenter.get();
 	}
-	/// @brief Setup texturing for the rendering context, enabling 2D texturing
-	/// @return true If texturing was setup successfully, false otherwise
-	bool Texture::SetupTexturing()
+	/// @brief Check if the presentation backend needs a native window
+	bool Texture::NeedsWindow() const
 	{
-		// Get and initialize the function pointer for wglSwapInterval
-		wglSwapInterval = reinterpret_cast<wglSwapInterval_t*>(
-			wglGetProcAddress("wglSwapIntervalEXT"));
-
-		// If wglSwapInterval is available, set it to 0 to disable V-Sync
-		if (wglSwapInterval) {
-			wglSwapInterval(0);
+		return pPresenter && pPresenter->NeedsWindow();
+	}
+	/// @brief Prepare the presentation backend for frames of the default draw target
+	/// @param width Width of the frames
+	/// @param height Height of the frames
+	/// @param viewport The viewport state for the rendering context
+	/// @return True if the backend is ready to present, false otherwise
+	bool Texture::CreateTexture2D(const int width, const int height, const ViewportState viewport)
+	{
+		if (!pDefaultDrawTarget || pDefaultDrawTarget->Width() != width || pDefaultDrawTarget->Height() != height) {
+			std::cerr << "Texture::CreateTexture2D: Default draw target does not match " << width << "x" << height << std::endl;
+			return false;
 		}
-
-		// Enable 2D texturing in OpenGL
-		glEnable(GL_TEXTURE_2D);
-
-		// Generate and bind a texture
-		GLuint textureID;
-		glGenTextures(1, &textureID);
-		if (textureID == 0) {
-			std::cerr << "Error: Unable to generate a texture" << std::endl;
+		if (!pPresenter->Create(pNativeWindow, *pDefaultDrawTarget, viewport)) {
+			std::cerr << "Texture::CreateTexture2D: Found an error in " << pPresenter->GetName() << " presenter" << std::endl;
 			return false;
 		}
-		// Bind 2D texture with texture ID
-		glBindTexture(GL_TEXTURE_2D, // target texture, which is 2D in this case.
-			textureID      // texture ID to bind to the target.
-		);
-
-		// Set the texture magnification filter to GL_NEAREST
-		glTexParameteri(
-			GL_TEXTURE_2D,         // target texture (2D in this case).
-			GL_TEXTURE_MAG_FILTER, // parameter to set (magnification filter).
-			GL_NEAREST // filter mode, where GL_NEAREST means nearest-neighbor
-					   // filtering.
-		);
-
-		// Set the texture minification filter to GL_NEAREST
-		glTexParameteri(
-			GL_TEXTURE_2D,         // target texture (2D in this case).
-			GL_TEXTURE_MIN_FILTER, // parameter to set (minification filter).
-			GL_NEAREST // filter mode, where GL_NEAREST means nearest-neighbor
-					   // filtering.
-		);
-
+		Invalidate();
 		return true;
 	}
-	/// @brief Setup the texture environment for the rendering context
-	/// @param width width of the texture.
-	/// @param height height of the texture.
-	/// @return true If the texture environment was setup successfully, false
-	bool Texture::SetupEnvironment(const int width, const int height) const
-	{
-		// Get the pixel data from the default draw target
-		const Pixel* target = pDefaultDrawTarget->GetData();
-		if (!target) {
-			std::cerr << "Error: Unable to get valid target data" << std::endl;
-			return false;
-		}
 
-		// Set the OpenGL texture environment mode to GL_DECAL
-		glTexEnvf(
-			GL_TEXTURE_ENV, // Specifies the target texture environment to modify.
-			GL_TEXTURE_ENV_MODE, // Specifies that you're setting the texture
-			// environment mode.
-			GL_DECAL             // Set a mode (REPLACE, MODULATE, DECAL, BLEND, ADD)
-					 //     GL_DECAL means the texture replaces the object's color.
-		);
-
-		// Specify the texture image data
-		glTexImage2D(
-			GL_TEXTURE_2D, // target texture type, which is 2D in this case.
-			0,       // level of detail for the mipmap level (0 is the base level).
-			GL_RGBA, // internal format of the texture, in this case, RGBA.
-			width, height,    // width and height of the texture.
-			0,                // border width (usually set to 0).
-			GL_RGBA,          // format of the pixel data (RGBA).
-			GL_UNSIGNED_BYTE, // data type of the pixel data (unsigned bytes).
-			target            // source of the image data (the 'target' variable).
-		);
+	///////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////// UPDATER ///////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
 
-		return true;
-	}
-	/// @brief Create a 2D texture with the specified width and height
+	/// @brief Render the texture on the screen
 	/// @param width Width of the texture
 	/// @param height Height of the texture
 	/// @param viewport The viewport state for the rendering context
-	/// @return True if the texture was created successfully, false otherwise
-	bool Texture::CreateTexture2D(const int width, const int height, const ViewportState viewport)
+	/// @return False if the presentation backend failed, true otherwise
+	bool Texture::RenderTexture(const int width, const int height, const ViewportState viewport) const
 	{
-		if (!SetupFormatter()) {
-			std::cerr << "Texture::CreateTexture2D: Found an error in Texture::SetupFormatter()" << std::endl;
-			return false;
-		}
-		if (!SetupRendering(viewport)) {
-			std::cerr << "Texture::CreateTexture2D: Found an error in Texture::SetupRendering()" << std::endl;
-			return false;
+		// A moved or resized viewport needs the whole frame presented again
+		if (viewport.GetX() != lastViewport.GetX() || viewport.GetY() != lastViewport.GetY() ||
+			viewport.GetWidth() != lastViewport.GetWidth() || viewport.GetHeight() != lastViewport.GetHeight()) {
+			lastViewport = viewport;
+			Invalidate();
 		}
-		if (!SetupTexturing()) {
-			std::cerr << "Texture::CreateTexture2D: Found an error in Texture::SetupTexturing()" << std::endl;
-			return false;
+
+		uFramePixelsWritten = uPixelsWritten.exchange(0);
+
+		// Nothing was drawn since the last frame, the presented frame is still valid
+		uUploadedBytes = 0;
+		const int32_t nLeft = std::max(nDirtyLeft, 0);
+		const int32_t nTop = std::max(nDirtyTop, 0);
+		const int32_t nRight = std::min(nDirtyRight, static_cast<int32_t>(width));
+		const int32_t nBottom = std::min(nDirtyBottom, static_cast<int32_t>(height));
+		if (nLeft >= nRight || nTop >= nBottom) {
+			return true;
 		}
-		if (!SetupEnvironment(width, height)) {
-			std::cerr << "Texture::CreateTexture2D: Found an error in Texture::SetupEnvironment()" << std::endl;
+
+		// Hand the changed region over to the presentation backend
+		if (!pPresenter->Present(*pDefaultDrawTarget, nLeft, nTop, nRight - nLeft, nBottom - nTop, viewport)) {
 			return false;
 		}
+		uUploadedBytes = static_cast<size_t>(nRight - nLeft) * (nBottom - nTop) * sizeof(Pixel);
+		ClearDirty();
 		return true;
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////
-	////////////////////////////////////// UPDATER ///////////////////////////////////////
+	//////////////////////////////////// DIRTY REGION /////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////////
 
-	/// @brief Set the viewport for rendering based on the specified viewport state
-	/// @param viewport Viewport state for the rendering context
-	void Texture::SetViewport(const ViewportState viewport)
+	/// @brief Grow the dirty region by a rectangle drawn on the default draw target
+	/// @param nPosX X-coordinate of the rectangle
+	/// @param nPosY Y-coordinate of the rectangle
+	/// @param nWidth Width of the rectangle
+	/// @param nHeight Height of the rectangle
+	void Texture::MarkDirty(const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight) const
 	{
-		glViewport(viewport.GetX(), viewport.GetY(), viewport.GetWidth(), viewport.GetHeight());
+		if (nWidth <= 0 || nHeight <= 0) {
+			return;
+		}
+		nDirtyLeft = std::min(nDirtyLeft, nPosX);
+		nDirtyTop = std::min(nDirtyTop, nPosY);
+		nDirtyRight = std::max(nDirtyRight, nPosX + nWidth);
+		nDirtyBottom = std::max(nDirtyBottom, nPosY + nHeight);
 	}
-	/// @brief Update the texture with new image data (subimage)
-	/// @param width Width of the texture
-	/// @param height Height of the texture
-	/// @param data Pixel data for the texture
-	void Texture::UpdateTexture(const int width, const int height, const Pixel* data)
+	/// @brief Empty the dirty region
+	void Texture::ClearDirty() const
 	{
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		nDirtyLeft = INT32_MAX;
+		nDirtyTop = INT32_MAX;
+		nDirtyRight = INT32_MIN;
+		nDirtyBottom = INT32_MIN;
 	}
-	/// @brief Display the texture on the screen
-	void Texture::DrawTextureOnScreen()
+	/// @brief Mark the whole default draw target as changed, so the next RenderTexture() uploads and presents it
+	void Texture::Invalidate() const
 	{
-		glBegin(GL_QUADS);
+		nDirtyLeft = 0;
+		nDirtyTop = 0;
+		nDirtyRight = pDefaultDrawTarget ? pDefaultDrawTarget->Width() : 0;
+		nDirtyBottom = pDefaultDrawTarget ? pDefaultDrawTarget->Height() : 0;
+	}
+	/// @brief Check if anything was drawn on the default draw target since the last RenderTexture()
+	bool Texture::IsDirty() const
+	{
+		return nDirtyLeft < nDirtyRight && nDirtyTop < nDirtyBottom;
+	}
+	/// @brief Getter for the number of bytes uploaded to the GPU by the last RenderTexture()
+	size_t Texture::GetUploadedBytes() const
+	{
+		return uUploadedBytes;
+	}
 
-		// Define vertices and texture coordinates for a quadrilateral
-		glTexCoord2f(0.0, 1.0);
-		glVertex3f(-1.0f, -1.0f, 0.0f);
-		glTexCoord2f(0.0, 0.0);
-		glVertex3f(-1.0f, +1.0f, 0.0f);
-		glTexCoord2f(1.0, 0.0);
-		glVertex3f(+1.0f, +1.0f, 0.0f);
-		glTexCoord2f(1.0, 1.0);
-		glVertex3f(+1.0f, -1.0f, 0.0f);
+	///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////// OVERDRAW //////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
 
-		// Finish drawing the quadrilateral
-		glEnd();
+	/// @brief Count a rectangle of pixels written on the default draw target (safe from several threads)
+	/// @param nWidth Width of the rectangle
+	/// @param nHeight Height of the rectangle
+	void Texture::CountWritten(const int32_t nWidth, const int32_t nHeight) const
+	{
+		if (pDrawTarget == pDefaultDrawTarget) {
+			uPixelsWritten.fetch_add(static_cast<size_t>(nWidth) * nHeight, std::memory_order_relaxed);
+		}
 	}
-	/// @brief Render the texture on the screen
-	/// @param width Width of the texture
-	/// @param height Height of the texture
-	/// @param viewport The viewport state for the rendering context
-	/// @return Always returns true by default
-	bool Texture::RenderTexture(const int width, const int height, const ViewportState viewport) const
+	/// @brief Getter for the number of pixels written for the last frame presented by RenderTexture()
+	size_t Texture::GetPixelsWritten() const
 	{
-		// Retrieve pixel data from the default draw target
-		const Pixel* target = pDefaultDrawTarget->GetData();
-
-		// Set the viewport for rendering based on the specified viewport state
-		SetViewport(viewport);
+		return uFramePixelsWritten;
+	}
+	/// @brief Getter for the pixels written per visible pixel of the last presented frame
+	/// @return 1.0 when every pixel was written once, above when some were drawn over, 0.0 for an idle frame
+	float Texture::GetOverdrawRatio() const
+	{
+		const int32_t nVisible = pDefaultDrawTarget ? pDefaultDrawTarget->Width() * pDefaultDrawTarget->Height() : 0;
+		if (nVisible <= 0) {
+			return 0.0f;
+		}
+		return static_cast<float>(uFramePixelsWritten) / static_cast<float>(nVisible);
+	}
+	/// @brief Show the overdraw ratio of the last presented frame, for the window title
+	std::string Texture::ShowOverdraw() const
+	{
+		const int nPercent = static_cast<int>(GetOverdrawRatio() * 100.0f + 0.5f);
+		return "[Overdraw: " + std::to_string(nPercent) + "%]";
+	}
 
-		// Update the texture with new image data (subimage)
-		UpdateTexture(width, height, target);
+	///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////// BATCHING //////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
 
-		// Display the texture on the screen
-		DrawTextureOnScreen();
+	/// @brief Start recording sprite draws on the default draw target instead of drawing them
+	void Texture::BeginBatch()
+	{
+		bBatching = true;
+	}
+	/// @brief Draw the recorded commands and stop recording
+	void Texture::EndBatch()
+	{
+		Flush();
+		bBatching = false;
+	}
+	/// @brief Draw the recorded commands sorted by layer then sprite. The default draw target is cut
+	///        into row bands, and each band replays the commands over it on its own thread.
+	void Texture::Flush()
+	{
+		uModeSwitches = 0;
+		if (queue.Empty()) {
+			return;
+		}
+		queue.Sort();
 
-		// Present graphics to the screen (swap buffers)
-		SwapBuffers(glDeviceContext);
+		// Dirty region and statistics are updated up front, the bands only write pixels
+		Pixel::Mode eMode = nPixelMode;
+		for (const DrawCommand& command : queue) {
+			if (command.eMode != eMode) {
+				eMode = command.eMode;
+				uModeSwitches++;
+			}
+			const int32_t nScale = static_cast<int32_t>(command.uScale);
+			const int32_t nLeft = std::max(command.nOffsetX, command.nClipLeft);
+			const int32_t nTop = std::max(command.nOffsetY, command.nClipTop);
+			const int32_t nRight = std::min(command.nOffsetX + command.nWidth * nScale, command.nClipRight);
+			const int32_t nBottom = std::min(command.nOffsetY + command.nHeight * nScale, command.nClipBottom);
+			MarkDirty(nLeft, nTop, nRight - nLeft, nBottom - nTop);
+		}
 
-		return true;
+		// Commands were recorded for the default draw target, whatever the current one is
+		Sprite* pSavedTarget = pDrawTarget;
+		pDrawTarget = pDefaultDrawTarget;
+		pDrawTarget->InvalidateOpaqueRuns(); // Written here once, not by the bands
+		const int32_t nTargetHeight = GetDrawTargetHeight();
+		if (nBandHeight <= 0 || nBandHeight >= nTargetHeight) {
+			RasterizeBand(0, nTargetHeight);
+		}
+		else {
+			const size_t uBands = static_cast<size_t>((nTargetHeight + nBandHeight - 1) / nBandHeight);
+			pool.Run(uBands, [this, nTargetHeight](const size_t uBand) {
+				const int32_t nTop = static_cast<int32_t>(uBand) * nBandHeight;
+				RasterizeBand(nTop, std::min(nTop + nBandHeight, nTargetHeight));
+			});
+		}
+		pDrawTarget = pSavedTarget;
+		queue.Clear();
+	}
+	/// @brief Check if sprite draws on the default draw target are currently recorded
+	bool Texture::IsBatching() const
+	{
+		return bBatching;
+	}
+	/// @brief Setter for the layer of the next recorded commands, lower layers are drawn first
+	/// @param nLayer The layer to set
+	void Texture::SetDrawLayer(const int32_t nLayer)
+	{
+		nDrawLayer = nLayer;
+	}
+	/// @brief Getter for the layer of the next recorded commands
+	int32_t Texture::GetDrawLayer() const
+	{
+		return nDrawLayer;
+	}
+	/// @brief Getter for the number of pixel mode changes made by the last Flush()
+	size_t Texture::GetModeSwitches() const
+	{
+		return uModeSwitches;
+	}
+	/// @brief Setter for the height of the row bands Flush() rasterizes in parallel
+	/// @param nHeight Rows per band, zero or less rasterizes the whole target on the calling thread
+	void Texture::SetBandHeight(const int32_t nHeight)
+	{
+		nBandHeight = nHeight;
+	}
+	/// @brief Getter for the height of the row bands Flush() rasterizes in parallel
+	int32_t Texture::GetBandHeight() const
+	{
+		return nBandHeight;
+	}
+	/// @brief Getter for the number of threads Flush() rasterizes on, including the calling thread
+	size_t Texture::GetRasterThreadCount() const
+	{
+		return pool.GetThreadCount();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////
@@ -370,6 +414,9 @@ namespace app
 	void Texture::SetDrawTarget(Sprite* target)
 	{
 		pDrawTarget = target ? target : pDefaultDrawTarget;
+		if (pDrawTarget->IsIndexed()) {
+			pDrawTarget->ConvertToRGBA(); // Draw targets are written pixel by pixel
+		}
 	}
 	/// @brief Setter for the current pixel drawing mode.
 	/// @param m Mode to set.
@@ -386,6 +433,7 @@ namespace app
 			fBlendFactor = 0.0f;
 		if (fBlendFactor > 1.0f)
 			fBlendFactor = 1.0f;
+		uBlendFactor = kernel::ToFactor(fBlendFactor);
 	}
 	/// @brief Set the default draw target.
 	/// @param width Width of the draw target.
@@ -398,6 +446,7 @@ namespace app
 			return false;
 		}
 		pDefaultDrawTarget = new Sprite(width, height);
+		Invalidate();
 		return true;
 	}
 	/// @brief Set the default target size.
@@ -417,85 +466,500 @@ namespace app
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////
-	//////////////////////////// DRAWING FUNCTIONS ////////////////////////////////////////
+	/////////////////////////////////// CLIPPING //////////////////////////////////////////
 	///////////////////////////////////////////////////////////////////////////////////////
 
-	/// @brief Draw a pixel at the specified coordinates with the given color.
-	/// @brief  - Solid color without transparency: <app::Pixel::NORMAL>
-	/// @brief  - Only draw solid color (alpha = 255): <app::Pixel::MASK>
-	/// @brief  - Fully transparent with alpha blending: <app::Pixel::ALPHA>
-	/// @brief  - Only transparency color (alpha # 255): <app::Pixel::BACKGROUND>
-	///
+	/// @brief Restrict the draws on the current draw target to a rectangle, until the matching PopClipRect().
+	/// @brief Every draw routine (sprites, pixels, Clear() and Modulate()) skips the pixels outside of it,
+	///        before any pixel is read or written. Draw targets other than the one it was pushed for are not clipped.
+	/// @param nPosX The X-coordinate of the rectangle (top-left corner).
+	/// @param nPosY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @return True if some part of the draw target can still be written, false otherwise (it is pushed anyway).
+	bool Texture::PushClipRect(const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight)
+	{
+		const ClipRect current = GetClipRect();
+		ClipRect clip;
+		clip.pTarget = pDrawTarget;
+		clip.nLeft = std::max(current.nLeft, nPosX);
+		clip.nTop = std::max(current.nTop, nPosY);
+		clip.nRight = std::max(clip.nLeft, std::min(current.nRight, nPosX + nWidth));
+		clip.nBottom = std::max(clip.nTop, std::min(current.nBottom, nPosY + nHeight));
+		vecClipStack.push_back(clip);
+		return clip.nLeft < clip.nRight && clip.nTop < clip.nBottom;
+	}
+	/// @brief Restore the clip rectangle in use before the last PushClipRect().
+	/// @return True if a rectangle was popped, false if the stack was empty.
+	bool Texture::PopClipRect()
+	{
+		if (vecClipStack.empty()) {
+			std::cerr << "Error: No clip rectangle to pop." << std::endl;
+			return false;
+		}
+		vecClipStack.pop_back();
+		return true;
+	}
+	/// @brief Getter for the rectangle of the draw target that may be written, the whole draw target
+	///        unless the top of the clip stack was pushed for it.
+	Texture::ClipRect Texture::GetClipRect() const
+	{
+		if (!vecClipStack.empty() && vecClipStack.back().pTarget == pDrawTarget) {
+			return vecClipStack.back();
+		}
+		ClipRect clip;
+		clip.pTarget = pDrawTarget;
+		clip.nLeft = 0;
+		clip.nTop = 0;
+		clip.nRight = GetDrawTargetWidth();
+		clip.nBottom = GetDrawTargetHeight();
+		return clip;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////// DRAWING HELPERS //////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Snapshot of the current pixel mode and blend factor, clipped to the current clip rectangle.
+	Texture::RasterState Texture::GetRasterState() const
+	{
+		const ClipRect clip = GetClipRect();
+		RasterState state;
+		state.eMode = nPixelMode;
+		state.fBlendFactor = fBlendFactor;
+		state.uBlendFactor = uBlendFactor;
+		state.nClipLeft = clip.nLeft;
+		state.nClipTop = clip.nTop;
+		state.nClipRight = clip.nRight;
+		state.nClipBottom = clip.nBottom;
+		state.bMarkDirty = pDrawTarget == pDefaultDrawTarget;
+		return state;
+	}
+	/// @brief Clip a destination rectangle against the clip rectangle of the draw, shifting the source origin along.
+	/// @param nOffsetX The X-coordinate for drawing (clipped in place).
+	/// @param nOffsetY The Y-coordinate for drawing (clipped in place).
+	/// @param nOriginX The X-coordinate of the source area (shifted in place).
+	/// @param nOriginY The Y-coordinate of the source area (shifted in place).
+	/// @param nWidth The width of the area (clipped in place).
+	/// @param nHeight The height of the area (clipped in place).
+	/// @param state The rectangle of the draw target that may be written.
+	/// @return True if some part of the area is still visible, false otherwise.
+	bool Texture::ClipRegion(int32_t& nOffsetX, int32_t& nOffsetY, int32_t& nOriginX, int32_t& nOriginY, int32_t& nWidth, int32_t& nHeight, const RasterState& state) const
+	{
+		if (nOffsetX < state.nClipLeft) {
+			const int32_t nCut = state.nClipLeft - nOffsetX;
+			nOriginX += nCut;
+			nWidth -= nCut;
+			nOffsetX = state.nClipLeft;
+		}
+		if (nOffsetY < state.nClipTop) {
+			const int32_t nCut = state.nClipTop - nOffsetY;
+			nOriginY += nCut;
+			nHeight -= nCut;
+			nOffsetY = state.nClipTop;
+		}
+		nWidth = std::min(nWidth, state.nClipRight - nOffsetX);
+		nHeight = std::min(nHeight, state.nClipBottom - nOffsetY);
+		return nWidth > 0 && nHeight > 0;
+	}
+	/// @brief Draw a scaled portion of a sprite through the blitter instantiated for the current pixel mode and scale.
+	/// @brief The region is clipped once up front, then the blitter walks the target row by row without further checks.
+	/// @param nOffsetX The X-coordinate for drawing.
+	/// @param nOffsetY The Y-coordinate for drawing.
+	/// @param pSprite The sprite to draw.
+	/// @param nOriginX The X-coordinate of the source area (top-left corner).
+	/// @param nOriginY The Y-coordinate of the source area (top-left corner).
+	/// @param nWidth The width of the source area.
+	/// @param nHeight The height of the source area.
+	/// @param uScale The scaling factor to apply when drawing the sprite.
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	/// @param state The pixel mode, blend factor and rows to draw with.
+	/// @return True if the region was handled (drawn or fully clipped), false if the visible source area
+	///         leaves the sprite bounds and must be sampled pixel by pixel instead.
+	bool Texture::BlitPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale, const Sprite::Flip eFlip, const RasterState& state)
+	{
+		if (!pDrawTarget) {
+			std::cerr << "Error: Draw target is not set." << std::endl;
+			return true;
+		}
+
+		// Clip in destination pixels, counting how many scaled pixels were cut from the top-left
+		const int32_t nScale = static_cast<int32_t>(uScale);
+		int32_t nSkipX = 0;
+		int32_t nSkipY = 0;
+		int32_t nDstWidth = nWidth * nScale;
+		int32_t nDstHeight = nHeight * nScale;
+		if (!ClipRegion(nOffsetX, nOffsetY, nSkipX, nSkipY, nDstWidth, nDstHeight, state)) {
+			return true;
+		}
+
+		if (state.bMarkDirty) {
+			MarkDirty(nOffsetX, nOffsetY, nDstWidth, nDstHeight);
+		}
+		CountWritten(nDstWidth, nDstHeight);
+
+		// Source area (in mirrored sprite coordinates) actually sampled by the visible destination pixels
+		const int32_t nFirstX = nOriginX + nSkipX / nScale;
+		const int32_t nFirstY = nOriginY + nSkipY / nScale;
+		const int32_t nLastX = nOriginX + (nSkipX + nDstWidth - 1) / nScale;
+		const int32_t nLastY = nOriginY + (nSkipY + nDstHeight - 1) / nScale;
+		if (!pSprite->Inside(nFirstX, nFirstY) || !pSprite->Inside(nLastX, nLastY)) {
+			return false;
+		}
+
+		// Mirrored rows and columns are walked backwards through the stored sprite
+		const bool bFlipX = (eFlip & Sprite::HORIZONTAL) != 0;
+		const bool bFlipY = (eFlip & Sprite::VERTICAL) != 0;
+		const int32_t nSrcX = bFlipX ? pSprite->Width() - 1 - nFirstX : nFirstX;
+		const int32_t nSrcY = bFlipY ? pSprite->Height() - 1 - nFirstY : nFirstY;
+
+		blit::Region region;
+		region.nDstPitch = pDrawTarget->Width();
+		region.nSrcPitch = bFlipY ? -pSprite->Width() : pSprite->Width();
+		region.nSrcStep = bFlipX ? -1 : 1;
+		region.pDst = pDrawTarget->GetData() + nOffsetY * region.nDstPitch + nOffsetX;
+		const bool bIndexed = pSprite->IsIndexed();
+		region.pSrc = bIndexed ? nullptr : pSprite->GetData() + nSrcY * pSprite->Width() + nSrcX;
+		region.pSrcIndex = bIndexed ? pSprite->GetIndices() + nSrcY * pSprite->Width() + nSrcX : nullptr;
+		region.pPalette = pSprite->GetPalette();
+		region.nWidth = nDstWidth;
+		region.nHeight = nDstHeight;
+		region.uScale = uScale;
+		region.uPhaseX = static_cast<uint32_t>(nSkipX % nScale);
+		region.uPhaseY = static_cast<uint32_t>(nSkipY % nScale);
+		region.uFactor = state.uBlendFactor;
+		region.pSprite = pSprite;
+		region.nSrcX = nSrcX;
+		region.nSrcY = nSrcY;
+		blit::Select(state.eMode, uScale, bFlipX, bIndexed)(region);
+		return true;
+	}
+	/// @brief Draw an unscaled area of a periodic sprite, split into the in-bounds pieces of the wrapped
+	///        source area so each piece goes through the row-span blitters instead of periodic sampling.
+	/// @param nOffsetX The X-coordinate for drawing.
+	/// @param nOffsetY The Y-coordinate for drawing.
+	/// @param pSprite The periodic sprite to draw.
+	/// @param nOriginX The X-coordinate of the source area (top-left corner, non-negative).
+	/// @param nOriginY The Y-coordinate of the source area (top-left corner, non-negative).
+	/// @param nWidth The width of the source area (may exceed the sprite width).
+	/// @param nHeight The height of the source area (may exceed the sprite height).
+	/// @param state The pixel mode, blend factor and rows to draw with.
+	void Texture::BlitPeriodicSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const RasterState& state)
+	{
+		const int32_t nSpriteWidth = pSprite->Width();
+		const int32_t nSpriteHeight = pSprite->Height();
+		if (nSpriteWidth <= 0 || nSpriteHeight <= 0) {
+			return;
+		}
+		int32_t nSrcY = nOriginY % nSpriteHeight;
+		for (int32_t nRow = 0; nRow < nHeight; nSrcY = 0) {
+			const int32_t nRows = std::min(nHeight - nRow, nSpriteHeight - nSrcY);
+			int32_t nSrcX = nOriginX % nSpriteWidth;
+			for (int32_t nCol = 0; nCol < nWidth; nSrcX = 0) {
+				const int32_t nCols = std::min(nWidth - nCol, nSpriteWidth - nSrcX);
+				BlitPartialSprite(nOffsetX + nCol, nOffsetY + nRow, pSprite, nSrcX, nSrcY, nCols, nRows, 1, Sprite::NONE, state);
+				nCol += nCols;
+			}
+			nRow += nRows;
+		}
+	}
+	/// @brief Draw a scaled portion of a sprite on the draw target right away.
+	/// @param nOffsetX The X-coordinate for drawing.
+	/// @param nOffsetY The Y-coordinate for drawing.
+	/// @param pSprite The sprite to draw.
+	/// @param nOriginX The X-coordinate of the source area (top-left corner).
+	/// @param nOriginY The Y-coordinate of the source area (top-left corner).
+	/// @param nWidth The width of the source area.
+	/// @param nHeight The height of the source area.
+	/// @param uScale The scaling factor to apply when drawing the sprite.
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	/// @param state The pixel mode, blend factor and rows to draw with.
+	void Texture::RasterizePartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale, const Sprite::Flip eFlip, const RasterState& state)
+	{
+		if (pSprite == nullptr || uScale == 0) {
+			return;
+		}
+		if (pSprite->GetSampleMode() == Sprite::PERIODIC && uScale == 1 && eFlip == Sprite::NONE && nOriginX >= 0 && nOriginY >= 0) {
+			return BlitPeriodicSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nWidth, nHeight, state);
+		}
+		if (BlitPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nWidth, nHeight, uScale, eFlip, state)) {
+			return;
+		}
+		const bool bFlipX = (eFlip & Sprite::HORIZONTAL) != 0;
+		const bool bFlipY = (eFlip & Sprite::VERTICAL) != 0;
+		for (int32_t nPartialX = 0; nPartialX < nWidth; nPartialX++) {
+			for (int32_t nPartialY = 0; nPartialY < nHeight; nPartialY++) {
+				const int nPosX = nOffsetX + (nPartialX * uScale);
+				const int nPosY = nOffsetY + (nPartialY * uScale);
+				const int32_t nSampleX = bFlipX ? pSprite->Width() - 1 - (nPartialX + nOriginX) : nPartialX + nOriginX;
+				const int32_t nSampleY = bFlipY ? pSprite->Height() - 1 - (nPartialY + nOriginY) : nPartialY + nOriginY;
+				const Pixel pixel = pSprite->GetPixel(nSampleX, nSampleY);
+				RasterizePixel(nPosX, nPosY, pixel, uScale, state);
+			}
+		}
+	}
+	/// @brief Fill a rectangle of the draw target with a repeated tile right away. The first row of tiles is
+	///        built once, its rows widened by doubling memcpys, and the next rows of tiles are copies of it.
+	/// @param nOffsetX The X-coordinate of the rectangle (top-left corner).
+	/// @param nOffsetY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @param pSprite The sprite holding the tile.
+	/// @param nOriginX The X-coordinate of the tile in the sprite (top-left corner).
+	/// @param nOriginY The Y-coordinate of the tile in the sprite (top-left corner).
+	/// @param nTileWidth The width of the tile.
+	/// @param nTileHeight The height of the tile.
+	/// @param nPhaseX The tile column drawn at nOffsetX.
+	/// @param state The pixel mode, blend factor and rectangle to draw with.
+	void Texture::RasterizeTiled(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nTileWidth, const int32_t nTileHeight, const int32_t nPhaseX, const RasterState& state)
+	{
+		if (!pDrawTarget || pSprite == nullptr || nTileWidth <= 0 || nTileHeight <= 0) {
+			return;
+		}
+		if (!pSprite->Inside(nOriginX, nOriginY) || !pSprite->Inside(nOriginX + nTileWidth - 1, nOriginY + nTileHeight - 1)) {
+			std::cerr << "Error: Tile is outside of the sprite." << std::endl;
+			return;
+		}
+		int32_t nSkipX = 0;
+		int32_t nSkipY = 0;
+		if (!ClipRegion(nOffsetX, nOffsetY, nSkipX, nSkipY, nWidth, nHeight, state)) {
+			return;
+		}
+		if (state.bMarkDirty) {
+			MarkDirty(nOffsetX, nOffsetY, nWidth, nHeight);
+		}
+		CountWritten(nWidth, nHeight);
+
+		// Solid tiles are built straight into the target, other modes build them into a scratch area applied as spans
+		// (unscaled RGBA blitters never use the scratch row themselves)
+		const bool bDirect = state.eMode == Pixel::NORMAL;
+		const int32_t nDstPitch = pDrawTarget->Width();
+		Pixel* pDst = pDrawTarget->GetData() + static_cast<ptrdiff_t>(nOffsetY) * nDstPitch + nOffsetX;
+		const int32_t nRows = std::min(nHeight, nTileHeight);
+		const int32_t nPitch = bDirect ? nDstPitch : nWidth;
+		Pixel* pRows = bDirect ? pDst : blit::ScratchRow(nWidth * nRows);
+		const int32_t nPhase = ((nPhaseX + nSkipX) % nTileWidth + nTileWidth) % nTileWidth;
+		const int32_t nPeriod = std::min(nWidth, nTileWidth);
+		for (int32_t nRow = 0; nRow < nRows; nRow++) {
+			Pixel* pRow = pRows + static_cast<ptrdiff_t>(nRow) * nPitch;
+			const int32_t nTileY = nOriginY + (nSkipY + nRow) % nTileHeight;
+			for (int32_t nCol = 0; nCol < nPeriod; nCol++) {
+				pRow[nCol] = pSprite->GetPixel(nOriginX + (nPhase + nCol) % nTileWidth, nTileY);
+			}
+			blit::RepeatRow(pRow, nPeriod, nWidth);
+		}
+
+		if (bDirect) {
+			for (int32_t nRow = nRows; nRow < nHeight; nRow++) {
+				std::memcpy(pDst + static_cast<ptrdiff_t>(nRow) * nDstPitch, pDst + static_cast<ptrdiff_t>(nRow - nTileHeight) * nDstPitch, nWidth * sizeof(Pixel));
+			}
+			return;
+		}
+		blit::Region region;
+		region.nDstPitch = nDstPitch;
+		region.nSrcPitch = nWidth;
+		region.nSrcStep = 1;
+		region.pSrc = pRows;
+		region.pSrcIndex = nullptr;
+		region.pPalette = nullptr;
+		region.nWidth = nWidth;
+		region.uScale = 1;
+		region.uPhaseX = 0;
+		region.uPhaseY = 0;
+		region.uFactor = state.uBlendFactor;
+		region.pSprite = nullptr;
+		region.nSrcX = 0;
+		region.nSrcY = 0;
+		const blit::BlitFunction Run = blit::Select(state.eMode, 1);
+		for (int32_t nRow = 0; nRow < nHeight; nRow += nRows) {
+			region.pDst = pDst + static_cast<ptrdiff_t>(nRow) * nDstPitch;
+			region.nHeight = std::min(nRows, nHeight - nRow);
+			Run(region);
+		}
+	}
+	/// @brief Draw a pixel on the draw target with the given state, see Draw().
 	/// @param x The X-coordinate.
 	/// @param y The Y-coordinate.
 	/// @param current_pixel The pixel color being applied.
-	/// @param uScale The scaling factor of pixel being drawn
+	/// @param uScale The scaling factor of pixel being drawn (non-zero).
+	/// @param state The pixel mode, blend factor and rows to draw with.
 	/// @return True if all the pixels was drawn successfully, false otherwise.
-	bool Texture::Draw(const int32_t x, const int32_t y, const Pixel current_pixel, const uint32_t uScale)
+	bool Texture::RasterizePixel(const int32_t x, const int32_t y, const Pixel current_pixel, const uint32_t uScale, const RasterState& state)
 	{
-		if (!pDrawTarget) {
-			std::cerr << "Error: Draw target is not set." << std::endl;
-			return false;
+		if (uScale > 1) { // Enlarge the pixel being drawn, as a 1x1 sprite through the scaled blitter
+			int32_t nOffsetX = x;
+			int32_t nOffsetY = y;
+			int32_t nSkipX = 0;
+			int32_t nSkipY = 0;
+			int32_t nWidth = static_cast<int32_t>(uScale);
+			int32_t nHeight = static_cast<int32_t>(uScale);
+			if (!ClipRegion(nOffsetX, nOffsetY, nSkipX, nSkipY, nWidth, nHeight, state)) {
+				return false;
+			}
+			if (state.bMarkDirty) {
+				MarkDirty(nOffsetX, nOffsetY, nWidth, nHeight);
+			}
+			CountWritten(nWidth, nHeight);
+			blit::Region region;
+			region.nDstPitch = pDrawTarget->Width();
+			region.nSrcPitch = 0;
+			region.nSrcStep = 0;
+			region.pDst = pDrawTarget->GetData() + nOffsetY * region.nDstPitch + nOffsetX;
+			region.pSrc = &current_pixel;
+			region.pSrcIndex = nullptr;
+			region.pPalette = nullptr;
+			region.nWidth = nWidth;
+			region.nHeight = nHeight;
+			region.uScale = uScale;
+			region.uPhaseX = static_cast<uint32_t>(nSkipX);
+			region.uPhaseY = static_cast<uint32_t>(nSkipY);
+			region.uFactor = state.uBlendFactor;
+			region.pSprite = nullptr;
+			region.nSrcX = 0;
+			region.nSrcY = 0;
+			blit::Select(state.eMode, uScale)(region);
+			return nWidth == static_cast<int32_t>(uScale) && nHeight == static_cast<int32_t>(uScale);
 		}
 
-		if (uScale == 0) {
-			std::cerr << "Error: Zero scaling factor means drawing nothing" << std::endl;
+		if (x < state.nClipLeft || x >= state.nClipRight || y < state.nClipTop || y >= state.nClipBottom) {
 			return false;
 		}
 
-		if (uScale > 1) { // Enlarge the pixel being drawn
-			bool success = true;
-			for (uint32_t uScaledX = x; uScaledX < x + uScale; uScaledX++) {
-				for (uint32_t uScaledY = y; uScaledY < y + uScale; uScaledY++) {
-					success &= Draw(uScaledX, uScaledY, current_pixel);
-				}
+		if (pDrawTarget->Inside(x, y)) {
+			if (state.bMarkDirty) {
+				MarkDirty(x, y, 1, 1);
 			}
-			return success;
+			CountWritten(1, 1);
 		}
 
-		if (nPixelMode == Pixel::NORMAL) {
+		if (state.eMode == Pixel::NORMAL) {
 			return pDrawTarget->SetPixel(x, y, current_pixel);
 		}
 
-		if (nPixelMode == Pixel::MASK) {
+		if (state.eMode == Pixel::MASK) {
 			if (current_pixel.a == 255) {
 				return pDrawTarget->SetPixel(x, y, current_pixel);
 			}
 		}
 
-		if (nPixelMode == Pixel::BACKGROUND) {
+		if (state.eMode == Pixel::BACKGROUND) {
 			if (current_pixel.a != 255) {
 				return pDrawTarget->SetPixel(x, y, current_pixel);
 			}
 		}
 
-		if (nPixelMode == Pixel::ALPHA) {
+		if (state.eMode == Pixel::ALPHA) {
+			const Pixel existed_pixel = pDrawTarget->GetPixel(x, y);
+			const Pixel blended_pixel = blend(current_pixel, existed_pixel, state.fBlendFactor);
+			return pDrawTarget->SetPixel(x, y, blended_pixel);
+		}
+
+		if (state.eMode == Pixel::PREMULTIPLIED) {
+			const Pixel existed_pixel = pDrawTarget->GetPixel(x, y);
+			const Pixel blended_pixel = kernel::PremultipliedBlendPixel(current_pixel, existed_pixel, state.uBlendFactor);
+			return pDrawTarget->SetPixel(x, y, blended_pixel);
+		}
+
+		if (state.eMode == Pixel::ADD) {
+			const Pixel existed_pixel = pDrawTarget->GetPixel(x, y);
+			const Pixel blended_pixel = kernel::AddBlendPixel(current_pixel, existed_pixel, state.uBlendFactor);
+			return pDrawTarget->SetPixel(x, y, blended_pixel);
+		}
+
+		if (state.eMode == Pixel::MULTIPLY) {
 			const Pixel existed_pixel = pDrawTarget->GetPixel(x, y);
-			const Pixel blended_pixel = blend(current_pixel, existed_pixel, GetBlendFactor());
+			const Pixel blended_pixel = kernel::MultiplyBlendPixel(current_pixel, existed_pixel, state.uBlendFactor);
+			return pDrawTarget->SetPixel(x, y, blended_pixel);
+		}
+
+		if (state.eMode == Pixel::SCREEN) {
+			const Pixel existed_pixel = pDrawTarget->GetPixel(x, y);
+			const Pixel blended_pixel = kernel::ScreenBlendPixel(current_pixel, existed_pixel, state.uBlendFactor);
 			return pDrawTarget->SetPixel(x, y, blended_pixel);
 		}
 
 		return false;
 	}
+	/// @brief Replay the recorded commands over a row band of the default draw target.
+	/// @brief Bands do not share rows, so several of them can be rasterized at the same time.
+	/// @param nTop First row of the band.
+	/// @param nBottom One past the last row of the band.
+	void Texture::RasterizeBand(const int32_t nTop, const int32_t nBottom)
+	{
+		RasterState state;
+		state.bMarkDirty = false;
+		for (const DrawCommand& command : queue) {
+			state.nClipLeft = command.nClipLeft;
+			state.nClipTop = std::max(nTop, command.nClipTop);
+			state.nClipRight = command.nClipRight;
+			state.nClipBottom = std::min(nBottom, command.nClipBottom);
+			const int32_t nScale = static_cast<int32_t>(command.uScale);
+			if (command.nOffsetY >= state.nClipBottom || command.nOffsetY + command.nHeight * nScale <= state.nClipTop) {
+				continue;
+			}
+			state.eMode = command.eMode;
+			state.fBlendFactor = command.fBlendFactor;
+			state.uBlendFactor = kernel::ToFactor(command.fBlendFactor);
+			if (command.nTileWidth > 0) {
+				RasterizeTiled(command.nOffsetX, command.nOffsetY, command.nWidth, command.nHeight, command.pSprite, command.nOriginX, command.nOriginY, command.nTileWidth, command.nTileHeight, command.nPhaseX, state);
+				continue;
+			}
+			RasterizePartialSprite(command.nOffsetX, command.nOffsetY, command.pSprite, command.nOriginX, command.nOriginY, command.nWidth, command.nHeight, command.uScale, command.eFlip, state);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////// DRAWING FUNCTIONS ////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Draw a pixel at the specified coordinates with the given color.
+	/// @brief  - Solid color without transparency: <app::Pixel::NORMAL>
+	/// @brief  - Only draw solid color (alpha = 255): <app::Pixel::MASK>
+	/// @brief  - Fully transparent with alpha blending: <app::Pixel::ALPHA>
+	/// @brief  - Only transparency color (alpha # 255): <app::Pixel::BACKGROUND>
+	/// @brief  - Premultiplied color composited over the background: <app::Pixel::PREMULTIPLIED>
+	/// @brief  - Color added to the background (saturating): <app::Pixel::ADD>
+	/// @brief  - Background multiplied by the color: <app::Pixel::MULTIPLY>
+	/// @brief  - Background screened with the color: <app::Pixel::SCREEN>
+	///
+	/// @param x The X-coordinate.
+	/// @param y The Y-coordinate.
+	/// @param current_pixel The pixel color being applied.
+	/// @param uScale The scaling factor of pixel being drawn
+	/// @return True if all the pixels was drawn successfully, false otherwise.
+	bool Texture::Draw(const int32_t x, const int32_t y, const Pixel current_pixel, const uint32_t uScale)
+	{
+		if (!pDrawTarget) {
+			std::cerr << "Error: Draw target is not set." << std::endl;
+			return false;
+		}
+
+		if (uScale == 0) {
+			std::cerr << "Error: Zero scaling factor means drawing nothing" << std::endl;
+			return false;
+		}
+
+		if (bBatching && pDrawTarget == pDefaultDrawTarget) { // Pixels are drawn at once, over the recorded sprites
+			Flush();
+		}
+
+		return RasterizePixel(x, y, current_pixel, uScale, GetRasterState());
+	}
 	/// @brief Draw a scaled sprite at the specified coordinates.
 	/// @param nOffsetX The top left X-coordinate.
 	/// @param nOffsetY The top left Y-coordinate.
 	/// @param pSprite  The sprite to draw.
 	/// @param uScale   The scaling factor (initially 1)
-	void Texture::DrawSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const uint32_t uScale)
+	/// @param eFlip    The mirroring applied to the sprite (initially none)
+	void Texture::DrawSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const uint32_t uScale, const Sprite::Flip eFlip)
 	{
 		if (pSprite == nullptr || uScale == 0) {
 			return;
 		}
-		for (int32_t nSpriteX = 0; nSpriteX < pSprite->Width(); nSpriteX++) {
-			for (int32_t nSpriteY = 0; nSpriteY < pSprite->Height(); nSpriteY++) {
-				const Pixel pixel = pSprite->GetPixel(nSpriteX, nSpriteY);
-				Draw(nOffsetX + nSpriteX * uScale, nOffsetY + nSpriteY * uScale, pixel,
-					uScale);
-			}
-		}
+		DrawPartialSprite(nOffsetX, nOffsetY, pSprite, 0, 0, pSprite->Width(), pSprite->Height(), uScale, eFlip);
 	}
 	/// @brief Draw a scaled portion of a sprite at the specified coordinates with scaling.
+	/// @brief While batching, draws on the default draw target are recorded and drawn by the next Flush().
 	/// @param nOffsetX The X-coordinate for drawing.
 	/// @param nOffsetY The Y-coordinate for drawing.
 	/// @param pSprite The sprite to draw.
@@ -504,19 +968,37 @@ namespace app
 	/// @param nWidth The width of the source area.
 	/// @param nHeight The height of the source area.
 	/// @param uScale The scaling factor to apply when drawing the sprite.
-	void Texture::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale)
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	void Texture::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nWidth, const int32_t nHeight, const uint32_t uScale, const Sprite::Flip eFlip)
 	{
 		if (pSprite == nullptr || uScale == 0) {
 			return;
 		}
-		for (int32_t nPartialX = 0; nPartialX < nWidth; nPartialX++) {
-			for (int32_t nPartialY = 0; nPartialY < nHeight; nPartialY++) {
-				const int nPosX = nOffsetX + (nPartialX * uScale);
-				const int nPosY = nOffsetY + (nPartialY * uScale);
-				const Pixel pixel = pSprite->GetPixel(nPartialX + nOriginX, nPartialY + nOriginY);
-				Draw(nPosX, nPosY, pixel, uScale);
-			}
+		if (bBatching && pDrawTarget == pDefaultDrawTarget) {
+			DrawCommand command;
+			command.pSprite = pSprite;
+			command.nOffsetX = nOffsetX;
+			command.nOffsetY = nOffsetY;
+			command.nOriginX = nOriginX;
+			command.nOriginY = nOriginY;
+			command.nWidth = nWidth;
+			command.nHeight = nHeight;
+			command.nTileWidth = 0;
+			command.nTileHeight = 0;
+			command.nPhaseX = 0;
+			command.uScale = uScale;
+			command.eFlip = eFlip;
+			command.eMode = nPixelMode;
+			command.fBlendFactor = fBlendFactor;
+			command.nLayer = nDrawLayer;
+			const ClipRect clip = GetClipRect();
+			command.nClipLeft = clip.nLeft;
+			command.nClipTop = clip.nTop;
+			command.nClipRight = clip.nRight;
+			command.nClipBottom = clip.nBottom;
+			return queue.Push(command);
 		}
+		RasterizePartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nWidth, nHeight, uScale, eFlip, GetRasterState());
 	}
 	/// @brief Draw partial sprite with default scaling factor, width and height.
 	/// @param nOffsetX The X-coordinate for drawing.
@@ -524,17 +1006,124 @@ namespace app
 	/// @param pSprite The sprite to draw.
 	/// @param nOriginX The X-coordinate of the source area (top-left corner).
 	/// @param nOriginY The Y-coordinate of the source area (top-left corner).
-	void Texture::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY)
+	/// @param eFlip The mirroring applied to the whole sprite, the source area is taken from the mirrored sprite.
+	void Texture::DrawPartialSprite(const int32_t nOffsetX, const int32_t nOffsetY, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const Sprite::Flip eFlip)
 	{
-		return DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nDefaultWidth, nDefaultHeight);
+		return DrawPartialSprite(nOffsetX, nOffsetY, pSprite, nOriginX, nOriginY, nDefaultWidth, nDefaultHeight, 1, eFlip);
 	}
-	/// @brief Clear the draw target with the specified color.
+	/// @brief Fill a rectangle with a tile of a sprite repeated in both directions, e.g. a lane background.
+	/// @brief Much cheaper than drawing the tile once per cell: the tile is read once per row, the rest is memcpys.
+	/// @brief While batching, draws on the default draw target are recorded and drawn by the next Flush().
+	/// @param nOffsetX The X-coordinate of the rectangle (top-left corner).
+	/// @param nOffsetY The Y-coordinate of the rectangle (top-left corner), where the first tile row is drawn.
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @param pSprite The sprite holding the tile.
+	/// @param nOriginX The X-coordinate of the tile in the sprite (top-left corner).
+	/// @param nOriginY The Y-coordinate of the tile in the sprite (top-left corner).
+	/// @param nTileWidth The width of the tile.
+	/// @param nTileHeight The height of the tile.
+	/// @param nPhaseX The tile column drawn at nOffsetX (scrolls the tiles left by that many pixels).
+	void Texture::DrawTiled(const int32_t nOffsetX, const int32_t nOffsetY, const int32_t nWidth, const int32_t nHeight, const Sprite* pSprite, const int32_t nOriginX, const int32_t nOriginY, const int32_t nTileWidth, const int32_t nTileHeight, const int32_t nPhaseX)
+	{
+		if (pSprite == nullptr || nTileWidth <= 0 || nTileHeight <= 0) {
+			return;
+		}
+		if (bBatching && pDrawTarget == pDefaultDrawTarget) {
+			DrawCommand command;
+			command.pSprite = pSprite;
+			command.nOffsetX = nOffsetX;
+			command.nOffsetY = nOffsetY;
+			command.nOriginX = nOriginX;
+			command.nOriginY = nOriginY;
+			command.nWidth = nWidth;
+			command.nHeight = nHeight;
+			command.nTileWidth = nTileWidth;
+			command.nTileHeight = nTileHeight;
+			command.nPhaseX = nPhaseX;
+			command.uScale = 1;
+			command.eFlip = Sprite::NONE;
+			command.eMode = nPixelMode;
+			command.fBlendFactor = fBlendFactor;
+			command.nLayer = nDrawLayer;
+			const ClipRect clip = GetClipRect();
+			command.nClipLeft = clip.nLeft;
+			command.nClipTop = clip.nTop;
+			command.nClipRight = clip.nRight;
+			command.nClipBottom = clip.nBottom;
+			return queue.Push(command);
+		}
+		RasterizeTiled(nOffsetX, nOffsetY, nWidth, nHeight, pSprite, nOriginX, nOriginY, nTileWidth, nTileHeight, nPhaseX, GetRasterState());
+	}
+	/// @brief Clear the draw target (inside the clip rectangle) with the specified color.
 	/// @param pixel Pixel color to clear
-	void Texture::Clear(const Pixel pixel) const
+	void Texture::Clear(const Pixel pixel)
 	{
-		const int size = GetDrawTargetSize();
+		const ClipRect clip = GetClipRect();
+		const int32_t nWidth = clip.nRight - clip.nLeft;
+		const int32_t nHeight = clip.nBottom - clip.nTop;
+		const bool bWhole = nWidth == GetDrawTargetWidth() && nHeight == GetDrawTargetHeight();
+		if (bBatching && pDrawTarget == pDefaultDrawTarget) {
+			if (bWhole) { // Recorded sprites would be covered anyway
+				queue.Clear();
+			}
+			else {
+				Flush();
+			}
+		}
+		if (nWidth <= 0 || nHeight <= 0) {
+			return;
+		}
 		Pixel* targets = GetDrawTarget()->GetData();
-		std::fill_n(targets, size, pixel);
+		if (bWhole) {
+			std::fill_n(targets, GetDrawTargetSize(), pixel);
+		}
+		else {
+			for (int32_t y = clip.nTop; y < clip.nBottom; y++) {
+				std::fill_n(targets + static_cast<ptrdiff_t>(y) * GetDrawTargetWidth() + clip.nLeft, nWidth, pixel);
+			}
+		}
+		if (pDrawTarget == pDefaultDrawTarget) {
+			MarkDirty(clip.nLeft, clip.nTop, nWidth, nHeight);
+		}
+		CountWritten(nWidth, nHeight);
+	}
+	/// @brief Darken a rectangle of the draw target (inside the clip rectangle) by per-pixel weights, after everything recorded so far is drawn
+	/// @param nOffsetX The X-coordinate of the rectangle (top-left corner).
+	/// @param nOffsetY The Y-coordinate of the rectangle (top-left corner).
+	/// @param nWidth The width of the rectangle.
+	/// @param nHeight The height of the rectangle.
+	/// @param pWeights The weights of the rectangle, row by row (0 is black, 255 leaves the pixel unchanged)
+	/// @param nPitch The number of weights per row (at least nWidth)
+	void Texture::Modulate(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const uint8_t* pWeights, const int32_t nPitch)
+	{
+		if (bBatching && pDrawTarget == pDefaultDrawTarget) { // Darken what was recorded, not what is drawn after
+			Flush();
+		}
+		const ClipRect clip = GetClipRect();
+		if (nOffsetX < clip.nLeft) {
+			pWeights += clip.nLeft - nOffsetX;
+			nWidth -= clip.nLeft - nOffsetX;
+			nOffsetX = clip.nLeft;
+		}
+		if (nOffsetY < clip.nTop) {
+			pWeights += static_cast<ptrdiff_t>(clip.nTop - nOffsetY) * nPitch;
+			nHeight -= clip.nTop - nOffsetY;
+			nOffsetY = clip.nTop;
+		}
+		nWidth = std::min(nWidth, clip.nRight - nOffsetX);
+		nHeight = std::min(nHeight, clip.nBottom - nOffsetY);
+		if (nWidth <= 0 || nHeight <= 0) {
+			return;
+		}
+		Pixel* pTarget = GetDrawTarget()->GetData() + static_cast<ptrdiff_t>(nOffsetY) * GetDrawTargetWidth() + nOffsetX;
+		for (int32_t y = 0; y < nHeight; y++) {
+			kernel::ModulateRow(pTarget + static_cast<ptrdiff_t>(y) * GetDrawTargetWidth(), pWeights + static_cast<ptrdiff_t>(y) * nPitch, nWidth);
+		}
+		if (pDrawTarget == pDefaultDrawTarget) {
+			MarkDirty(nOffsetX, nOffsetY, nWidth, nHeight);
+		}
+		CountWritten(nWidth, nHeight);
 	}
 } // namespace app
 
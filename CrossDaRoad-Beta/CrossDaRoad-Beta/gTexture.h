@@ -3,67 +3,125 @@
  *
  * @brief Contains texture class
  *
- * This file contains texture class for drawing textures on screen using OpenGL.
+ * This file contains texture class for drawing textures on screen through a presentation backend.
 **/
 
 #ifndef G_TEXTURE_H
 #define G_TEXTURE_H
 
-#pragma comment(lib, "opengl32.lib")
-#include <Windows.h>
-#include <GL/gl.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 #include "gPixel.h"
+#include "gPresenter.h"
+#include "gRenderQueue.h"
 #include "gState.h"
 #include "gSprite.h"
+#include "gThreadPool.h"
 
 namespace app
 {
-	/// @brief OpenGL function pointers for dynamic linking
-	typedef BOOL(WINAPI wglSwapInterval_t)(int interval);
-	static wglSwapInterval_t* wglSwapInterval;
-	/// @brief Class for drawing textures on screen using OpenGL
+	/// @brief Class for drawing textures on screen, shown through a presentation backend (OpenGL, headless, ...)
 	class Texture
 	{
-	private: // OpenGL Environment variables
-		HDC glDeviceContext;   ///< Device context for OpenGL rendering context
-		HGLRC glRenderContext; ///< Rendering context for OpenGL
-		GLuint glBuffer;       ///< OpenGL buffer for texture
+	private: // Presentation environment variables
+		void* pNativeWindow;                  ///< Native window handle given to the presenter (nullptr when headless)
+		std::unique_ptr<Presenter> pPresenter; ///< Backend presenting the default draw target
 
 	private: // Drawing variables
 		Sprite* pDefaultDrawTarget; ///< Default draw target for drawing on screen (window) using OpenGL functions
 		Sprite* pDrawTarget;        ///< Draw target for drawing on screen (window) using OpenGL functions
 		Pixel::Mode nPixelMode;     ///< Pixel mode for drawing on screen (window) using OpenGL functions
 		float fBlendFactor;         ///< Blend factor for drawing on screen (window) using OpenGL functions
+		uint8_t uBlendFactor;       ///< Blend factor in 8-bit fixed point, used by the row kernels
 		int nDefaultWidth;			///< Default width of draw target
 		int nDefaultHeight;			///< Default height of draw target
 
+	private: // Dirty region of the default draw target, uploaded by the next RenderTexture()
+		mutable int32_t nDirtyLeft;     ///< Left edge of the changed pixels (inclusive)
+		mutable int32_t nDirtyTop;      ///< Top edge of the changed pixels (inclusive)
+		mutable int32_t nDirtyRight;    ///< Right edge of the changed pixels (exclusive)
+		mutable int32_t nDirtyBottom;   ///< Bottom edge of the changed pixels (exclusive)
+		mutable ViewportState lastViewport; ///< Viewport of the last presented frame
+		mutable size_t uUploadedBytes;  ///< Bytes uploaded to the GPU by the last RenderTexture()
+
+	private: // Overdraw statistics of the default draw target
+		mutable std::atomic<size_t> uPixelsWritten; ///< Pixels written since the last RenderTexture()
+		mutable size_t uFramePixelsWritten;         ///< Pixels written for the last frame presented by RenderTexture()
+
+	private: // Deferred drawing on the default draw target, replayed by Flush()
+		RenderQueue queue;       ///< Commands recorded since BeginBatch() or the last Flush()
+		bool bBatching;          ///< If sprite draws on the default draw target are recorded instead of drawn
+		int32_t nDrawLayer;      ///< Layer given to the recorded commands
+		size_t uModeSwitches;    ///< Pixel mode changes made by the last Flush()
+		ThreadPool pool;         ///< Workers rasterizing the row bands of a flush
+		int32_t nBandHeight;     ///< Height of the row bands rasterized in parallel (0 rasterizes serially)
+
+	private: // Clipping, the top rectangle restricts the draws on the target it was pushed for
+		/// @brief Rectangle of a draw target that may be written
+		struct ClipRect
+		{
+			const Sprite* pTarget; ///< Draw target the rectangle applies to
+			int32_t nLeft;         ///< Left edge (inclusive)
+			int32_t nTop;          ///< Top edge (inclusive)
+			int32_t nRight;        ///< Right edge (exclusive)
+			int32_t nBottom;       ///< Bottom edge (exclusive)
+		};
+		std::vector<ClipRect> vecClipStack; ///< Pushed rectangles, each already intersected with the one below
+
+	private: // Rasterizer state, passed down each draw so row bands can be rasterized concurrently
+		/// @brief Pixel mode, blend factor and clip rectangle of one draw
+		struct RasterState
+		{
+			Pixel::Mode eMode;     ///< Pixel mode
+			float fBlendFactor;    ///< Blend factor
+			uint8_t uBlendFactor;  ///< Blend factor in 8-bit fixed point
+			int32_t nClipLeft;     ///< First column of the draw target that may be written
+			int32_t nClipTop;      ///< First row of the draw target that may be written
+			int32_t nClipRight;    ///< One past the last column of the draw target that may be written
+			int32_t nClipBottom;   ///< One past the last row of the draw target that may be written
+			bool bMarkDirty;       ///< If the written area grows the dirty region
+		};
+
 	public: // Constructors & Destructors
 		Texture();
-		Texture(HWND windowHandler);
+		Texture(void* pWindow);
 		~Texture();
-		bool CreateDeviceContext(HWND windowHandler);
+		bool CreateDeviceContext(void* pWindow);
 		bool ExitDevice() const;
 
 	private: // Constructors & Destructors helpers
 		bool InitDevice();
 
-	private: // Setup enviroment helpers
-		bool SetupFormatter() const;
-		bool SetupRendering(ViewportState viewport);
-		static bool SetupTexturing();
-		bool SetupEnvironment(int width, int height) const;
+	public: // Presenter
+		bool SetPresenter(std::unique_ptr<Presenter> presenter);
+		Presenter* GetPresenter() const;
+		bool NeedsWindow() const;
 
 	public: // Setup enviroment
 		bool CreateTexture2D(int width, int height, ViewportState viewport);
 
-	private: // Updater helpers
-		static void SetViewport(ViewportState viewport);
-		static void UpdateTexture(int width, int height, const Pixel* data);
-		static void DrawTextureOnScreen();
-
 	public: // Updater
 		bool RenderTexture(int width, int height, ViewportState viewport) const;
 
+	private: // Dirty region helpers
+		void MarkDirty(int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight) const;
+		void ClearDirty() const;
+
+	public: // Dirty region
+		void Invalidate() const;
+		bool IsDirty() const;
+		size_t GetUploadedBytes() const;
+
+	private: // Overdraw helpers
+		void CountWritten(int32_t nWidth, int32_t nHeight) const;
+
+	public: // Overdraw
+		size_t GetPixelsWritten() const;
+		float GetOverdrawRatio() const;
+		std::string ShowOverdraw() const;
+
 	public: // Drawing Getters
 		Sprite* GetDrawTarget() const;
 		Sprite* GetDefaultDrawTarget() const;
@@ -80,12 +138,41 @@ namespace app
 		bool SetDefaultDrawTarget(int32_t width, int32_t height);
 		bool SetDefaultTargetSize(int32_t width, int32_t height);
 
+	public: // Clipping
+		bool PushClipRect(int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight);
+		bool PopClipRect();
+
+	public: // Batching
+		void BeginBatch();
+		void EndBatch();
+		void Flush();
+		bool IsBatching() const;
+		void SetDrawLayer(int32_t nLayer);
+		int32_t GetDrawLayer() const;
+		size_t GetModeSwitches() const;
+		void SetBandHeight(int32_t nHeight);
+		int32_t GetBandHeight() const;
+		size_t GetRasterThreadCount() const;
+
+	private: // Drawing helpers
+		ClipRect GetClipRect() const;
+		RasterState GetRasterState() const;
+		bool ClipRegion(int32_t& nOffsetX, int32_t& nOffsetY, int32_t& nOriginX, int32_t& nOriginY, int32_t& nWidth, int32_t& nHeight, const RasterState& state) const;
+		bool BlitPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale, Sprite::Flip eFlip, const RasterState& state);
+		void BlitPeriodicSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, const RasterState& state);
+		void RasterizePartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale, Sprite::Flip eFlip, const RasterState& state);
+		void RasterizeTiled(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nTileWidth, int32_t nTileHeight, int32_t nPhaseX, const RasterState& state);
+		bool RasterizePixel(int32_t x, int32_t y, Pixel current_pixel, uint32_t uScale, const RasterState& state);
+		void RasterizeBand(int32_t nTop, int32_t nBottom);
+
 	public: // Drawing functions
 		bool Draw(int32_t x, int32_t y, Pixel current_pixel = app::WHITE, uint32_t uScale = 1);
-		void DrawSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, uint32_t uScale = 1);
-		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale = 1);
-		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY);
-		void Clear(Pixel pixel = app::BLACK) const;
+		void DrawSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, uint32_t uScale = 1, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nWidth, int32_t nHeight, uint32_t uScale = 1, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawPartialSprite(int32_t nOffsetX, int32_t nOffsetY, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, Sprite::Flip eFlip = Sprite::NONE);
+		void DrawTiled(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const Sprite* pSprite, int32_t nOriginX, int32_t nOriginY, int32_t nTileWidth, int32_t nTileHeight, int32_t nPhaseX = 0);
+		void Clear(Pixel pixel = app::BLACK);
+		void Modulate(int32_t nOffsetX, int32_t nOffsetY, int32_t nWidth, int32_t nHeight, const uint8_t* pWeights, int32_t nPitch);
 	};
 }
 
@@ -0,0 +1,129 @@
+/**
+ * @file gThreadPool.cpp
+ *
+ * @brief Contains thread pool class implementation
+ *
+ * This file implements the worker threads and the blocking Run() used to split a job into tasks.
+**/
+
+#include "gThreadPool.h"
+
+namespace app
+{
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////// CONSTRUCTORS & DESTRUCTOR ///////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Default constructor, one worker per hardware thread besides the calling one
+	ThreadPool::ThreadPool()
+		: ThreadPool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0)
+	{
+	}
+	/// @brief Parameterized constructor
+	/// @param uWorkers Number of worker threads (0 runs every task on the calling thread)
+	ThreadPool::ThreadPool(const size_t uWorkers)
+		: pTask(nullptr), uTasks(0), uNextTask(0), uGeneration(0), uBusyWorkers(0), bStopping(false)
+	{
+		vecWorkers.reserve(uWorkers);
+		for (size_t i = 0; i < uWorkers; i++) {
+			vecWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+	/// @brief Destructor, waits for the workers to exit
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutexJob);
+			bStopping = true;
+		}
+		cvStart.notify_all();
+		for (std::thread& worker : vecWorkers) {
+			worker.join();
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the number of threads running tasks, including the calling thread
+	size_t ThreadPool::GetThreadCount() const
+	{
+		return vecWorkers.size() + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// RUNNING ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Run task(0) .. task(uTaskCount - 1) on the workers and the calling thread, return when all are done
+	/// @param uTaskCount Number of tasks
+	/// @param task Task to run, called concurrently with different indices
+	void ThreadPool::Run(const size_t uTaskCount, const std::function<void(size_t)>& task)
+	{
+		if (uTaskCount == 0) {
+			return;
+		}
+		if (vecWorkers.empty() || uTaskCount == 1) {
+			for (size_t i = 0; i < uTaskCount; i++) {
+				task(i);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutexJob);
+			pTask = &task;
+			uTasks = uTaskCount;
+			uNextTask = 0;
+			uBusyWorkers = vecWorkers.size();
+			uGeneration++;
+		}
+		cvStart.notify_all();
+
+		RunTasks(task, uTaskCount);
+
+		std::unique_lock<std::mutex> lock(mutexJob);
+		cvDone.wait(lock, [this] { return uBusyWorkers == 0; });
+		pTask = nullptr;
+	}
+	/// @brief Take and run tasks until none is left
+	/// @param task Task of the current job
+	/// @param uTaskCount Number of tasks of the current job
+	void ThreadPool::RunTasks(const std::function<void(size_t)>& task, const size_t uTaskCount)
+	{
+		for (size_t i = uNextTask++; i < uTaskCount; i = uNextTask++) {
+			task(i);
+		}
+	}
+	/// @brief Body of the worker threads, joins every posted job until the pool stops
+	void ThreadPool::WorkerLoop()
+	{
+		size_t uSeenGeneration = 0;
+		while (true) {
+			const std::function<void(size_t)>* pJobTask;
+			size_t uJobTasks;
+			{
+				std::unique_lock<std::mutex> lock(mutexJob);
+				cvStart.wait(lock, [&] { return bStopping || uGeneration != uSeenGeneration; });
+				if (bStopping) {
+					return;
+				}
+				uSeenGeneration = uGeneration;
+				pJobTask = pTask;
+				uJobTasks = uTasks;
+			}
+
+			RunTasks(*pJobTask, uJobTasks);
+
+			std::lock_guard<std::mutex> lock(mutexJob);
+			if (--uBusyWorkers == 0) {
+				cvDone.notify_one();
+			}
+		}
+	}
+} // namespace app
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// END OF FILE //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,56 @@
+/**
+ * @file gThreadPool.h
+ *
+ * @brief Contains thread pool class
+ *
+ * This file contains a fixed-size pool of worker threads for splitting a job into independent tasks.
+**/
+
+#ifndef G_THREAD_POOL_H
+#define G_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace app
+{
+	/// @brief Fixed-size pool of worker threads, running one job of indexed tasks at a time
+	class ThreadPool
+	{
+	private:
+		std::vector<std::thread> vecWorkers;     ///< Worker threads, the calling thread also runs tasks
+		std::mutex mutexJob;                     ///< Guards the job fields below
+		std::condition_variable cvStart;         ///< Wakes the workers when a job is posted or the pool stops
+		std::condition_variable cvDone;          ///< Wakes the caller when the last worker leaves the job
+		const std::function<void(size_t)>* pTask; ///< Task of the current job (nullptr if none)
+		size_t uTasks;                           ///< Number of tasks of the current job
+		std::atomic<size_t> uNextTask;           ///< Next task index to be taken
+		size_t uGeneration;                      ///< Incremented for every posted job
+		size_t uBusyWorkers;                     ///< Workers still inside the current job
+		bool bStopping;                          ///< If the workers should exit
+
+	public: // Constructors & Destructor
+		ThreadPool();
+		explicit ThreadPool(size_t uWorkers);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+	public: // Getters
+		size_t GetThreadCount() const;
+
+	public: // Running
+		void Run(size_t uTaskCount, const std::function<void(size_t)>& task);
+
+	private: // Running helpers
+		void RunTasks(const std::function<void(size_t)>& task, size_t uTaskCount);
+		void WorkerLoop();
+	};
+}
+
+#endif // G_THREAD_POOL_H
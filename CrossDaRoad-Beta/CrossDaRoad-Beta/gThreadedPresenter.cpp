@@ -0,0 +1,233 @@
+/**
+ * @file gThreadedPresenter.cpp
+ *
+ * @brief Contains threaded presentation backend implementation
+ *
+ * This file implements the render thread and the lock-free rotation of the three framebuffers:
+ * the engine thread swaps its written frame with the ready one, the render thread swaps the ready
+ * frame with the shown one, and the fresh flag tells whether the ready frame was taken yet.
+**/
+
+#include "gThreadedPresenter.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace app
+{
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// REGION /////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Grow the region to contain another one
+	/// @param other The region to contain
+	void ThreadedPresenter::Region::Merge(const Region& other)
+	{
+		if (other.Empty()) {
+			return;
+		}
+		if (Empty()) {
+			*this = other;
+			return;
+		}
+		nLeft = std::min(nLeft, other.nLeft);
+		nTop = std::min(nTop, other.nTop);
+		nRight = std::max(nRight, other.nRight);
+		nBottom = std::max(nBottom, other.nBottom);
+	}
+	/// @brief Check if the region contains no pixel
+	bool ThreadedPresenter::Region::Empty() const
+	{
+		return nLeft >= nRight || nTop >= nBottom;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////// CONSTRUCTORS & DESTRUCTOR ///////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Parameterized constructor
+	/// @param pPresenter The presenter to run on the render thread
+	ThreadedPresenter::ThreadedPresenter(std::unique_ptr<Presenter> pPresenter)
+		: pPresenter(std::move(pPresenter)), uReadyFrame(1), bStopping(false), bPresented(true),
+		uPresentedFrames(0), uSkippedFrames(0), uBackFrame(0), untakenRegion{ 0, 0, 0, 0 }, uFrontFrame(2)
+	{
+		for (Region& region : staleRegions) {
+			region = { 0, 0, 0, 0 };
+		}
+	}
+	/// @brief Destructor, stops the render thread
+	ThreadedPresenter::~ThreadedPresenter()
+	{
+		Destroy();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// PRESENTER ///////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Allocate the framebuffers, then start the render thread and wait for it to create the presenter
+	/// @param pNativeWindow Native window handle, given to the presenter on the render thread
+	/// @param frame The default draw target, holding the first frame
+	/// @param viewport The viewport the frames are shown in
+	/// @return True if the presenter was created on the render thread, false otherwise
+	bool ThreadedPresenter::Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport)
+	{
+		if (!pPresenter || renderThread.joinable()) {
+			std::cerr << "ThreadedPresenter::Create: No presenter to run, or render thread already running" << std::endl;
+			return false;
+		}
+		for (Frame& buffer : frames) {
+			buffer.pSprite.reset(new Sprite(frame.Width(), frame.Height()));
+			std::copy_n(frame.GetData(), frame.Width() * frame.Height(), buffer.pSprite->GetData());
+			buffer.changed = { 0, 0, 0, 0 };
+			buffer.viewport = viewport;
+		}
+		uReadyFrame = 1;
+		uBackFrame = 0;
+		uFrontFrame = 2;
+		untakenRegion = { 0, 0, 0, 0 };
+		for (Region& region : staleRegions) {
+			region = { 0, 0, 0, 0 };
+		}
+		bStopping = false;
+		bPresented = true;
+
+		// Rendering contexts belong to the thread creating them, so the presenter is created on the render thread
+		std::promise<bool> created;
+		std::future<bool> result = created.get_future();
+		renderThread = std::thread(&ThreadedPresenter::RenderLoop, this, pNativeWindow, &frame, viewport, &created);
+		if (!result.get()) {
+			renderThread.join();
+			return false;
+		}
+		return true;
+	}
+	/// @brief Show the last ready frame, then stop the render thread, which destroys the presenter
+	void ThreadedPresenter::Destroy()
+	{
+		if (!renderThread.joinable()) {
+			return;
+		}
+		bStopping = true;
+		cvWake.notify_one();
+		renderThread.join();
+	}
+	/// @brief Hand a frame over to the render thread, never waits for it
+	/// @param frame The default draw target
+	/// @param nPosX X-coordinate of the changed rectangle
+	/// @param nPosY Y-coordinate of the changed rectangle
+	/// @param nWidth Width of the changed rectangle
+	/// @param nHeight Height of the changed rectangle
+	/// @param viewport The viewport the frame is shown in
+	/// @return Result of the last presentation done by the render thread
+	bool ThreadedPresenter::Present(const Sprite& frame, const int32_t nPosX, const int32_t nPosY, const int32_t nWidth, const int32_t nHeight, const ViewportState& viewport)
+	{
+		if (!renderThread.joinable()) {
+			std::cerr << "ThreadedPresenter::Present: Render thread is not running" << std::endl;
+			return false;
+		}
+		const Region changed = { nPosX, nPosY, nPosX + nWidth, nPosY + nHeight };
+		for (Region& region : staleRegions) {
+			region.Merge(changed);
+		}
+
+		// Bring the back frame up to date, it only misses what changed since it was last written
+		Frame& back = frames[uBackFrame];
+		Region& stale = staleRegions[uBackFrame];
+		const int32_t nPitch = frame.Width();
+		for (int32_t y = stale.nTop; y < stale.nBottom; y++) {
+			std::copy_n(frame.GetData() + y * nPitch + stale.nLeft, stale.nRight - stale.nLeft, back.pSprite->GetData() + y * nPitch + stale.nLeft);
+		}
+		stale = { 0, 0, 0, 0 };
+
+		// If the ready frame is replaced before being taken, this frame also carries its changes
+		back.changed = untakenRegion;
+		back.changed.Merge(changed);
+		back.viewport = viewport;
+
+		const uint8_t uPrevious = uReadyFrame.exchange(static_cast<uint8_t>(uBackFrame | FRESH_FRAME), std::memory_order_acq_rel);
+		uBackFrame = static_cast<uint8_t>(uPrevious & ~FRESH_FRAME);
+		if (uPrevious & FRESH_FRAME) {
+			untakenRegion = back.changed;
+			uSkippedFrames++;
+		}
+		else {
+			untakenRegion = changed;
+		}
+		cvWake.notify_one();
+		return bPresented;
+	}
+	/// @brief Check if the presenter run on the render thread needs a window
+	bool ThreadedPresenter::NeedsWindow() const
+	{
+		return pPresenter && pPresenter->NeedsWindow();
+	}
+	/// @brief Name of the presenter run on the render thread
+	const char* ThreadedPresenter::GetName() const
+	{
+		return pPresenter ? pPresenter->GetName() : "Threaded";
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// GETTERS ////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Getter for the presenter run on the render thread, only safe to use while the thread is stopped
+	Presenter* ThreadedPresenter::GetInnerPresenter() const
+	{
+		return pPresenter.get();
+	}
+	/// @brief Getter for the number of frames shown by the render thread
+	uint64_t ThreadedPresenter::GetPresentedFrames() const
+	{
+		return uPresentedFrames;
+	}
+	/// @brief Getter for the number of frames replaced by a newer one before being shown
+	uint64_t ThreadedPresenter::GetSkippedFrames() const
+	{
+		return uSkippedFrames;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////// RENDER THREAD /////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Body of the render thread: create the presenter, show every fresh frame, destroy the presenter
+	/// @param pNativeWindow Native window handle given to the presenter
+	/// @param pFirstFrame The first frame, only read before pCreated is set
+	/// @param viewport The viewport the frames are shown in
+	/// @param pCreated Set to the result of the presenter creation
+	void ThreadedPresenter::RenderLoop(void* pNativeWindow, const Sprite* pFirstFrame, const ViewportState viewport, std::promise<bool>* pCreated)
+	{
+		const bool bCreated = pPresenter->Create(pNativeWindow, *pFirstFrame, viewport);
+		pCreated->set_value(bCreated);
+		if (!bCreated) {
+			return;
+		}
+
+		while (true) {
+			if (uReadyFrame.load(std::memory_order_acquire) & FRESH_FRAME) {
+				uFrontFrame = static_cast<uint8_t>(uReadyFrame.exchange(uFrontFrame, std::memory_order_acq_rel) & ~FRESH_FRAME);
+				const Frame& front = frames[uFrontFrame];
+				const Region& changed = front.changed;
+				bPresented = changed.Empty() || pPresenter->Present(*front.pSprite, changed.nLeft, changed.nTop, changed.nRight - changed.nLeft, changed.nBottom - changed.nTop, front.viewport);
+				uPresentedFrames++;
+				continue;
+			}
+			if (bStopping) {
+				break;
+			}
+			// The engine thread notifies without locking, a missed notification only delays the frame by the timeout
+			std::unique_lock<std::mutex> lock(mutexWake);
+			cvWake.wait_for(lock, std::chrono::milliseconds(1), [this] {
+				return bStopping || (uReadyFrame.load(std::memory_order_acquire) & FRESH_FRAME);
+			});
+		}
+
+		pPresenter->Destroy();
+	}
+} // namespace app
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// END OF FILE //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
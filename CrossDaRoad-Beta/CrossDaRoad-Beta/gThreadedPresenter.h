@@ -0,0 +1,90 @@
+/**
+ * @file gThreadedPresenter.h
+ *
+ * @brief Contains threaded presentation backend
+ *
+ * This file contains the presenter moving another presenter onto a render thread, fed through three
+ * framebuffers rotated lock-free so the engine thread never waits for a slow upload or buffer swap.
+**/
+
+#ifndef G_THREADED_PRESENTER_H
+#define G_THREADED_PRESENTER_H
+
+#include "gPresenter.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace app
+{
+	/// @brief Presenter running another presenter on its own render thread, with triple-buffered frames
+	class ThreadedPresenter : public Presenter
+	{
+	public:
+		static constexpr int FRAME_COUNT = 3;         ///< Written by the engine thread, ready, shown by the render thread
+		static constexpr uint8_t FRESH_FRAME = 0x80;  ///< Set on the ready index until the render thread takes it
+
+	private:
+		/// @brief Rectangle of changed pixels, empty when nLeft >= nRight or nTop >= nBottom
+		struct Region
+		{
+			int32_t nLeft, nTop, nRight, nBottom;
+			void Merge(const Region& other);
+			bool Empty() const;
+		};
+		/// @brief A framebuffer with the region changed since the frame the render thread showed before it
+		struct Frame
+		{
+			std::unique_ptr<Sprite> pSprite;
+			Region changed;
+			ViewportState viewport;
+		};
+
+	private: // Shared
+		std::unique_ptr<Presenter> pPresenter;  ///< Presenter run on the render thread
+		Frame frames[FRAME_COUNT];              ///< Triple-buffered frames
+		std::atomic<uint8_t> uReadyFrame;       ///< Index of the ready frame, with FRESH_FRAME if not taken yet
+		std::atomic<bool> bStopping;            ///< If the render thread should exit once the ready frame is shown
+		std::atomic<bool> bPresented;           ///< Result of the last presentation
+		std::atomic<uint64_t> uPresentedFrames; ///< Number of frames shown by the render thread
+		std::atomic<uint64_t> uSkippedFrames;   ///< Number of frames replaced before the render thread took them
+		std::thread renderThread;               ///< Thread owning the presenter
+		std::mutex mutexWake;                   ///< Only used to sleep on cvWake, never held by the engine thread
+		std::condition_variable cvWake;         ///< Wakes the render thread when a frame is ready
+
+	private: // Engine thread only
+		uint8_t uBackFrame;               ///< Frame being written
+		Region staleRegions[FRAME_COUNT]; ///< Pixels each frame misses from the latest frame
+		Region untakenRegion;             ///< Changes since the last frame the render thread took
+
+	private: // Render thread only
+		uint8_t uFrontFrame; ///< Frame being shown
+
+	public: // Constructors & Destructor
+		explicit ThreadedPresenter(std::unique_ptr<Presenter> pPresenter);
+		~ThreadedPresenter() override;
+		ThreadedPresenter(const ThreadedPresenter&) = delete;
+		ThreadedPresenter& operator=(const ThreadedPresenter&) = delete;
+
+	public: // Presenter
+		bool Create(void* pNativeWindow, const Sprite& frame, const ViewportState& viewport) override;
+		void Destroy() override;
+		bool Present(const Sprite& frame, int32_t nPosX, int32_t nPosY, int32_t nWidth, int32_t nHeight, const ViewportState& viewport) override;
+		bool NeedsWindow() const override;
+		const char* GetName() const override;
+
+	public: // Getters
+		Presenter* GetInnerPresenter() const;
+		uint64_t GetPresentedFrames() const;
+		uint64_t GetSkippedFrames() const;
+
+	private: // Render thread
+		void RenderLoop(void* pNativeWindow, const Sprite* pFirstFrame, ViewportState viewport, std::promise<bool>* pCreated);
+	};
+}
+
+#endif // G_THREADED_PRESENTER_H
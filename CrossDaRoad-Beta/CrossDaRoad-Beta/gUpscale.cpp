@@ -0,0 +1,192 @@
+/**
+ * @file gUpscale.cpp
+ *
+ * @brief Contains integer upscale kernels implementation
+ *
+ * This file implements scalar, SSE2 and AVX2 kernels replicating every source pixel uScale times along a row.
+ * Whole frames are upscaled in a single pass over the source: each row is expanded once, then copied to
+ * the other destination rows it covers.
+**/
+
+#include "gUpscale.h"
+#include "gBlend.h"
+#include "gSprite.h"
+#include "gSimd.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace app
+{
+	namespace kernel
+	{
+		//////////////////////////////////////////////////////////////////////////////////////////
+		////////////////////////////////////// ROW KERNELS ///////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Portable upscale kernel, one source pixel at a time
+		static void UpscaleRowScalar(Pixel* pDst, const Pixel* pSrc, const int32_t nWidth, const uint32_t uScale)
+		{
+			for (int32_t x = 0; x < nWidth; x++) {
+				std::fill_n(pDst + x * uScale, uScale, pSrc[x]);
+			}
+		}
+
+#ifdef G_SIMD_X86
+		/// @brief Replicate one pixel uScale (at least 4) times, the last store overlaps the previous one
+		G_TARGET_SSE2 static inline void BroadcastSSE2(Pixel* pDst, const Pixel pixel, const uint32_t uScale)
+		{
+			const __m128i v = _mm_set1_epi32(static_cast<int>(pixel.n));
+			for (uint32_t k = 0; k + 4 < uScale; k += 4) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + k), v);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + uScale - 4), v);
+		}
+
+		/// @brief SSE2 upscale kernel, four source pixels at a time through shuffles for scales 2 to 4
+		G_TARGET_SSE2 static void UpscaleRowSSE2(Pixel* pDst, const Pixel* pSrc, const int32_t nWidth, const uint32_t uScale)
+		{
+			int32_t x = 0;
+			switch (uScale) {
+			case 2:
+				for (; x + 4 <= nWidth; x += 4) {
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x));
+					__m128i* pOut = reinterpret_cast<__m128i*>(pDst + x * 2);
+					_mm_storeu_si128(pOut + 0, _mm_unpacklo_epi32(v, v));
+					_mm_storeu_si128(pOut + 1, _mm_unpackhi_epi32(v, v));
+				}
+				break;
+			case 3:
+				for (; x + 4 <= nWidth; x += 4) {
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x));
+					__m128i* pOut = reinterpret_cast<__m128i*>(pDst + x * 3);
+					_mm_storeu_si128(pOut + 0, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 0, 0)));
+					_mm_storeu_si128(pOut + 1, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 1, 1)));
+					_mm_storeu_si128(pOut + 2, _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 2)));
+				}
+				break;
+			case 4:
+				for (; x + 4 <= nWidth; x += 4) {
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x));
+					__m128i* pOut = reinterpret_cast<__m128i*>(pDst + x * 4);
+					_mm_storeu_si128(pOut + 0, _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+					_mm_storeu_si128(pOut + 1, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1)));
+					_mm_storeu_si128(pOut + 2, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2)));
+					_mm_storeu_si128(pOut + 3, _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)));
+				}
+				break;
+			default:
+				for (; x < nWidth; x++) {
+					BroadcastSSE2(pDst + x * uScale, pSrc[x], uScale);
+				}
+				break;
+			}
+			UpscaleRowScalar(pDst + x * uScale, pSrc + x, nWidth - x, uScale);
+		}
+
+		/// @brief AVX2 upscale kernel, eight source pixels at a time through permutes for scales 2 to 8
+		/// @note Destination vector j of a block holds source pixels (8 * j + i) / uScale, all inside the block
+		G_TARGET_AVX2 static void UpscaleRowAVX2(Pixel* pDst, const Pixel* pSrc, const int32_t nWidth, const uint32_t uScale)
+		{
+			if (uScale > 8) {
+				for (int32_t x = 0; x < nWidth; x++) {
+					const __m256i v = _mm256_set1_epi32(static_cast<int>(pSrc[x].n));
+					Pixel* pRun = pDst + x * uScale;
+					for (uint32_t k = 0; k + 8 < uScale; k += 8) {
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(pRun + k), v);
+					}
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pRun + uScale - 8), v);
+				}
+				return;
+			}
+
+			__m256i permutes[8];
+			for (uint32_t j = 0; j < uScale; j++) {
+				int32_t indices[8];
+				for (uint32_t i = 0; i < 8; i++) {
+					indices[i] = static_cast<int32_t>((8 * j + i) / uScale);
+				}
+				permutes[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+			}
+			int32_t x = 0;
+			for (; x + 8 <= nWidth; x += 8) {
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + x));
+				__m256i* pOut = reinterpret_cast<__m256i*>(pDst + x * uScale);
+				for (uint32_t j = 0; j < uScale; j++) {
+					_mm256_storeu_si256(pOut + j, _mm256_permutevar8x32_epi32(v, permutes[j]));
+				}
+			}
+			UpscaleRowSSE2(pDst + x * uScale, pSrc + x, nWidth - x, uScale);
+		}
+#endif // G_SIMD_X86
+
+		/// @brief Replicate every pixel of a source row uScale times
+		/// @param pDst The destination row, nWidth * uScale pixels
+		/// @param pSrc The source row
+		/// @param nWidth The number of source pixels
+		/// @param uScale The scaling factor (1 is a plain copy)
+		void UpscaleRow(Pixel* pDst, const Pixel* pSrc, const int32_t nWidth, const uint32_t uScale)
+		{
+			if (uScale <= 1) {
+				std::memcpy(pDst, pSrc, nWidth * sizeof(Pixel));
+				return;
+			}
+			switch (GetInstructionSet()) {
+#ifdef G_SIMD_X86
+			case AVX2:
+				return UpscaleRowAVX2(pDst, pSrc, nWidth, uScale);
+			case SSE2:
+				return UpscaleRowSSE2(pDst, pSrc, nWidth, uScale);
+#endif
+			default:
+				return UpscaleRowScalar(pDst, pSrc, nWidth, uScale);
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////
+		//////////////////////////////////////// FRAMES //////////////////////////////////////////
+		//////////////////////////////////////////////////////////////////////////////////////////
+
+		/// @brief Upscale an image by integer factors (nearest-neighbour), expanding each source row once
+		/// @param pDst The destination image, at least (nWidth * uScaleX) x (nHeight * uScaleY) pixels
+		/// @param nDstPitch Pixels per destination row
+		/// @param pSrc The source image
+		/// @param nSrcPitch Pixels per source row
+		/// @param nWidth Width of the source image
+		/// @param nHeight Height of the source image
+		/// @param uScaleX Horizontal scaling factor
+		/// @param uScaleY Vertical scaling factor
+		void Upscale(Pixel* pDst, const int32_t nDstPitch, const Pixel* pSrc, const int32_t nSrcPitch, const int32_t nWidth, const int32_t nHeight, const uint32_t uScaleX, const uint32_t uScaleY)
+		{
+			const size_t uRowBytes = static_cast<size_t>(nWidth) * uScaleX * sizeof(Pixel);
+			for (int32_t y = 0; y < nHeight; y++) {
+				Pixel* pRow = pDst + static_cast<size_t>(y) * uScaleY * nDstPitch;
+				UpscaleRow(pRow, pSrc + static_cast<size_t>(y) * nSrcPitch, nWidth, uScaleX);
+				for (uint32_t k = 1; k < uScaleY; k++) {
+					std::memcpy(pRow + static_cast<size_t>(k) * nDstPitch, pRow, uRowBytes);
+				}
+			}
+		}
+
+		/// @brief Upscale a sprite into a target whose size is an integer multiple of it
+		/// @param source The sprite to upscale, stored as RGBA
+		/// @param target The upscaled sprite, its size selects the scaling factors
+		/// @return False if the sizes are not integer multiples or a sprite has no RGBA pixels, true otherwise
+		bool UpscaleSprite(const Sprite& source, Sprite& target)
+		{
+			if (source.GetData() == nullptr || target.GetData() == nullptr || source.Width() <= 0 || source.Height() <= 0
+				|| target.Width() % source.Width() != 0 || target.Height() % source.Height() != 0) {
+				std::cerr << "kernel::UpscaleSprite: Target size is not an integer multiple of the source size" << std::endl;
+				return false;
+			}
+			const uint32_t uScaleX = static_cast<uint32_t>(target.Width() / source.Width());
+			const uint32_t uScaleY = static_cast<uint32_t>(target.Height() / source.Height());
+			Upscale(target.GetData(), target.Width(), source.GetData(), source.Width(), source.Width(), source.Height(), uScaleX, uScaleY);
+			return true;
+		}
+	} // namespace kernel
+} // namespace app
+
+//////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////// END OF FILE ////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,28 @@
+/**
+ * @file gUpscale.h
+ *
+ * @brief Contains integer upscale kernels
+ *
+ * This file contains vectorized nearest-neighbour upscale kernels, for showing or capturing frames at window resolution.
+**/
+
+#ifndef G_UPSCALE_H
+#define G_UPSCALE_H
+
+#include "gPixel.h"
+#include <cstdint>
+
+namespace app
+{
+	class Sprite;
+
+	/// @brief Namespace for row kernels, selected once at startup by CPU feature detection (see gBlend.h)
+	namespace kernel
+	{
+		void UpscaleRow(Pixel* pDst, const Pixel* pSrc, int32_t nWidth, uint32_t uScale);
+		void Upscale(Pixel* pDst, int32_t nDstPitch, const Pixel* pSrc, int32_t nSrcPitch, int32_t nWidth, int32_t nHeight, uint32_t uScaleX, uint32_t uScaleY);
+		bool UpscaleSprite(const Sprite& source, Sprite& target);
+	}
+}
+
+#endif // G_UPSCALE_H
@@ -7,7 +7,10 @@
 **/
 
 #include "gUtils.h"
+#ifdef _WIN32
 #include <Windows.h>
+#endif
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -18,6 +21,7 @@
  **/
 namespace app
 {
+#ifdef _WIN32
 	/// @brief Converts a string to a wide string (UTF-8 to wide string)
 	/// @param utf8String The string to be converted.
 	/// @return The converted wide string.
@@ -50,6 +54,62 @@ namespace app
 		}
 		return std::string(utf8Buffer.get());
 	}
+#else
+	/// @brief Converts a string to a wide string (UTF-8 to wide string, one wchar_t per code point)
+	/// @param utf8String The string to be converted.
+	/// @return The converted wide string, malformed bytes are skipped.
+	std::wstring to_wstring(const std::string& utf8String)
+	{
+		std::wstring wideString;
+		wideString.reserve(utf8String.size());
+		for (size_t i = 0; i < utf8String.size();) {
+			const unsigned char lead = static_cast<unsigned char>(utf8String[i]);
+			const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+			if (length == 0 || i + length > utf8String.size()) {
+				i++;
+				continue;
+			}
+			uint32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+			for (size_t k = 1; k < length; k++) {
+				codePoint = (codePoint << 6) | (static_cast<unsigned char>(utf8String[i + k]) & 0x3F);
+			}
+			wideString.push_back(static_cast<wchar_t>(codePoint));
+			i += length;
+		}
+		return wideString;
+	}
+
+	/// @brief Converts a wide string to a string (wide string to UTF-8)
+	/// @param wideString The string to be converted.
+	/// @return The converted utf8 string.
+	std::string to_string(const std::wstring& wideString)
+	{
+		std::string utf8String;
+		utf8String.reserve(wideString.size());
+		for (const wchar_t wideChar : wideString) {
+			const uint32_t codePoint = static_cast<uint32_t>(wideChar);
+			if (codePoint < 0x80) {
+				utf8String.push_back(static_cast<char>(codePoint));
+			}
+			else if (codePoint < 0x800) {
+				utf8String.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+				utf8String.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else if (codePoint < 0x10000) {
+				utf8String.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+				utf8String.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				utf8String.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else {
+				utf8String.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+				utf8String.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+				utf8String.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				utf8String.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+		}
+		return utf8String;
+	}
+#endif // _WIN32
 
 	static std::wstring WTEXT; // use local variable to avoid pointer issues
 
@@ -6,6 +6,9 @@
 
 #include "hMapDrawer.h"
 #include "cApp.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,12 +40,14 @@ GraphicCell::~GraphicCell() = default;
 hMapDrawer::hMapDrawer()
 {
 	app = nullptr;
+	nStaticLanes = 0;
 }
 
 /// @brief Parameterized constructor
 /// @param app Pointer to the application
 hMapDrawer::hMapDrawer(cApp* app)
 {
+	nStaticLanes = 0;
 	SetupTarget(app);
 }
 
@@ -70,30 +75,12 @@ bool hMapDrawer::SetupTarget(cApp* app)
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////// DRAWERS /////////////////////////////////////////////////
+/////////////////////////////////////// INTERNALITY ///////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// @brief Get lane backgrounds on screen
-/// @param Lane Lane to be drawn
-/// @return Vector of graphic cells representing the lane backgrounds
-std::vector<GraphicCell> hMapDrawer::GetLaneBackgrounds(const cMapLane& Lane) const
-{
-	const int nRow = Lane.GetLaneID();
-	const int nStartPos = Lane.GetStartPos(app->fTimeSinceStart);
-	const int nCellOffset = Lane.GetCellOffset(app->nCellSize, app->fTimeSinceStart);
-
-	std::vector<GraphicCell> Backgrounds;
-	for (int nCol = -1; nCol < app->nLaneWidth; nCol++) {
-		const char graphic = Lane.GetLaneGraphic(nStartPos + nCol);
-		Backgrounds.push_back(GraphicCell(graphic, nCellOffset, nRow, nCol));
-	}
-
-	return Backgrounds;
-}
-
 /// @brief Get lane objects on screen
 /// @param Lane Lane to be drawn
-/// @return Vector of graphic cells representing the lane objects
+/// @return Vector of graphic cells representing the lane objects, followed by the summoned objects
 std::vector<GraphicCell> hMapDrawer::GetLaneObjects(const cMapLane& Lane) const
 {
 	const int nRow = Lane.GetLaneID();
@@ -116,32 +103,485 @@ std::vector<GraphicCell> hMapDrawer::GetLaneObjects(const cMapLane& Lane) const
 
 	return Objects;
 }
+/// @brief Get pre-rendered strips of a lane, rendering the backgrounds again if the lane changed
+/// @param Lane Lane to be drawn
+/// @return Strips of the lane
+LaneStrip& hMapDrawer::GetLaneStrip(const cMapLane& Lane) const
+{
+	LaneStrip& Strip = mapLaneStrips[Lane.GetLaneID()];
+	const std::string sLane = Lane.GetLane();
+	if (Strip.sLane == sLane) {
+		return Strip;
+	}
+
+	Strip = LaneStrip();
+	Strip.sLane = sLane;
+	for (const char graphic : sLane) {
+		const MapObject sprite = app->MapLoader.GetSpriteData(graphic);
+		if (sprite.nID > 0 && std::find(Strip.vecFrames.begin(), Strip.vecFrames.end(), sprite.nID) == Strip.vecFrames.end()) {
+			Strip.vecFrames.push_back(sprite.nID);
+		}
+		Strip.nRevealRadius = std::max(Strip.nRevealRadius, sprite.nRevealRadius);
+		Strip.bBlended |= (sprite.eBlendMode != app::Pixel::MASK && sprite.nRevealRadius <= 0);
+	}
+	Strip.pBackground = RenderLaneStrip(Lane, false);
+	return Strip;
+}
+/// @brief Get the object strip of a lane for the current animation frame, rendered on first use
+/// @param Strip Strips of the lane
+/// @param Lane Lane to be drawn
+/// @return Object strip of the lane, nullptr if the lane has no objects
+const app::Sprite* hMapDrawer::GetLaneObjectStrip(LaneStrip& Strip, const cMapLane& Lane) const
+{
+	const int nFrameKey = GetFrameKey(Strip);
+	const auto it = Strip.mapObjects.find(nFrameKey);
+	if (it != Strip.mapObjects.end()) {
+		return it->second.get();
+	}
+	return (Strip.mapObjects[nFrameKey] = RenderLaneStrip(Lane, true)).get();
+}
+/// @brief Get the key of the current animation frames of the lane objects
+/// @param Strip Strips of the lane
+/// @return One digit (base 16) per animation used by the lane
+int hMapDrawer::GetFrameKey(const LaneStrip& Strip) const
+{
+	int nFrameKey = 0;
+	for (const int nFrame : Strip.vecFrames) {
+		nFrameKey = nFrameKey * 16 + app->GetFrameID(nFrame);
+	}
+	return nFrameKey;
+}
+/// @brief Get a premultiplied copy of an object sprite, so it can be faded in with its own transparency
+/// @param sName Name of the sprite (with its animation frame)
+/// @return The premultiplied sprite, copied on first use, nullptr if the sprite is not loaded
+const app::Sprite* hMapDrawer::GetRevealSprite(const std::string& sName) const
+{
+	const auto it = mapRevealSprites.find(sName);
+	if (it != mapRevealSprites.end()) {
+		return it->second.get();
+	}
+	const app::Sprite* source = cAssetManager::GetInstance().GetSprite(sName);
+	if (source == nullptr) {
+		return nullptr;
+	}
+	const auto pCopy = std::make_shared<app::Sprite>(source->Width(), source->Height());
+	app->SetDrawTarget(pCopy.get());
+	app->SetPixelMode(app::Pixel::NORMAL);
+	app->DrawSprite(0, 0, source);
+	app->SetDrawTarget(nullptr);
+	pCopy->Premultiply();
+	return (mapRevealSprites[sName] = pCopy).get();
+}
+/// @brief Get the squared distance between the centre of the player and the centre of a cell
+/// @param nPosX X-coordinate of the cell on screen
+/// @param nPosY Y-coordinate of the cell on screen
+/// @return Squared distance (in pixels)
+int hMapDrawer::GetPlayerDistance2(const int32_t nPosX, const int32_t nPosY) const
+{
+	const float fCellSize = static_cast<float>(app->nCellSize);
+	const int nPlayerX = static_cast<int>((app->Player.GetPlayerAnimationPositionX() + 0.5f) * fCellSize);
+	const int nPlayerY = static_cast<int>((app->Player.GetPlayerAnimationPositionY() + 0.5f) * fCellSize);
+	const int nDistX = nPosX + app->nCellSize / 2 - nPlayerX;
+	const int nDistY = nPosY + app->nCellSize / 2 - nPlayerY;
+	return nDistX * nDistX + nDistY * nDistY;
+}
+/// @brief Get the opacity of an object at some distance from the player, from a table of the
+///        smoothstep falloff indexed by the squared distance as a fraction of the squared radius
+/// @param nDistance2 Squared distance to the player (in pixels)
+/// @param nRadius Reveal radius of the object (in pixels)
+/// @return Opacity (0-255), 255 next to the player and 0 from the radius on
+uint8_t hMapDrawer::GetRevealAlpha(const int nDistance2, const int nRadius)
+{
+	static const std::array<uint8_t, 256> table = [] {
+		std::array<uint8_t, 256> alpha{};
+		for (size_t i = 0; i < alpha.size(); i++) {
+			const float t = 1.0f - std::sqrt(static_cast<float>(i) / 255.0f);
+			alpha[i] = static_cast<uint8_t>(255.0f * t * t * (3.0f - 2.0f * t) + 0.5f);
+		}
+		return alpha;
+	}();
+	const int nRadius2 = nRadius * nRadius;
+	if (nRadius <= 0 || nDistance2 >= nRadius2) {
+		return 0;
+	}
+	return table[static_cast<size_t>(static_cast<int64_t>(nDistance2) * 255 / nRadius2)];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////// PRE-RENDERERS //////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Render every cell of a lane once into a periodic strip of GetLaneSize() cells
+/// @param Lane Lane to be rendered
+/// @param bObjects True to render the objects (current animation frame), false to render the backgrounds
+/// @return The rendered strip, nullptr if no cell of the lane has anything of that kind to draw
+std::shared_ptr<app::Sprite> hMapDrawer::RenderLaneStrip(const cMapLane& Lane, const bool bObjects) const
+{
+	const int nLaneSize = static_cast<int>(Lane.GetLaneSize());
+	if (nLaneSize <= 0) {
+		return nullptr;
+	}
+
+	const auto pStrip = std::make_shared<app::Sprite>(nLaneSize * app->nCellSize, app->nCellSize);
+	std::fill_n(pStrip->GetData(), pStrip->Width() * pStrip->Height(), app::BLANK);
+	bool bEmpty = true;
+
+	app->SetDrawTarget(pStrip.get());
+	app->SetPixelMode(bObjects ? app::Pixel::MASK : app::Pixel::NORMAL);
+	for (int nPos = 0; nPos < nLaneSize; nPos++) {
+		const MapObject sprite = app->MapLoader.GetSpriteData(Lane.GetLaneGraphic(nPos));
+		const int32_t nPosX = nPos * app->nCellSize;
+		if (bObjects) {
+			const std::string sName = sprite.sSpriteName + (sprite.nID <= 0 ? "" : app->ShowFrameID(sprite.nID));
+			if (sprite.sSpriteName.empty() || sprite.nRevealRadius > 0 || sprite.eBlendMode != app::Pixel::MASK) {
+				continue; // Revealed and blended objects are drawn by DrawRevealedObjects() and DrawBlendedObjects()
+			}
+			const int32_t nDrawX = sprite.nSpritePosX * app_const::SPRITE_WIDTH;
+			const int32_t nDrawY = sprite.nSpritePosY * app_const::SPRITE_HEIGHT;
+			const int nFlip = (sprite.isFlippedX ? app::Sprite::HORIZONTAL : 0) | (sprite.isFlippedY ? app::Sprite::VERTICAL : 0);
+			const app::Sprite* object = cAssetManager::GetInstance().GetSprite(sName);
+			app->DrawPartialSprite(nPosX, 0, object, nDrawX, nDrawY, static_cast<app::Sprite::Flip>(nFlip));
+		}
+		else {
+			if (sprite.sBackgroundName.empty()) {
+				continue;
+			}
+			// Consecutive cells with the same background tile are filled at once
+			const auto IsSameBackground = [&](const int nNext) {
+				const MapObject next = app->MapLoader.GetSpriteData(Lane.GetLaneGraphic(nNext));
+				return next.sBackgroundName == sprite.sBackgroundName && next.nBackgroundPosX == sprite.nBackgroundPosX && next.nBackgroundPosY == sprite.nBackgroundPosY;
+			};
+			int nCells = 1;
+			while (nPos + nCells < nLaneSize && IsSameBackground(nPos + nCells)) {
+				nCells++;
+			}
+			const int32_t nDrawX = sprite.nBackgroundPosX * app_const::SPRITE_WIDTH;
+			const int32_t nDrawY = sprite.nBackgroundPosY * app_const::SPRITE_HEIGHT;
+			const app::Sprite* background = cAssetManager::GetInstance().GetSprite(sprite.sBackgroundName);
+			app->DrawTiled(nPosX, 0, nCells * app->nCellSize, app->nCellSize, background, nDrawX, nDrawY, app_const::SPRITE_WIDTH, app_const::SPRITE_HEIGHT);
+			nPos += nCells - 1;
+		}
+		bEmpty = false;
+	}
+	app->SetPixelMode(app::Pixel::NORMAL);
+	app->SetDrawTarget(nullptr);
+
+	if (bEmpty) {
+		return nullptr;
+	}
+	pStrip->SetSampleMode(app::Sprite::PERIODIC);
+	pStrip->BuildOpaqueRuns();
+	return pStrip;
+}
+/// @brief Pre-render the strips of all lanes of the current level (current animation frame)
+/// @return Always true by default
+bool hMapDrawer::BuildLaneStrips()
+{
+	mapLaneStrips.clear();
+	mapRevealSprites.clear();
+	const std::vector<cMapLane> vecLanes = app->MapLoader.GetLanes();
+	for (const cMapLane& lane : vecLanes) {
+		GetLaneObjectStrip(GetLaneStrip(lane), lane);
+	}
+	return true;
+}
+/// @brief Render the lanes whose pixels cannot change once into the static layer, and fill their
+///        collision zones once. Must be called after BuildLaneStrips() with the zone patterns set.
+/// @return Number of lanes classified static
+int hMapDrawer::BuildStaticLayer()
+{
+	pStaticLayer = nullptr;
+	nStaticLanes = 0;
+
+	std::vector<cMapLane> vecStaticLanes;
+	const std::vector<cMapLane> vecLanes = app->MapLoader.GetLanes();
+	int nLayerHeight = 0;
+	for (const cMapLane& lane : vecLanes) {
+		if (IsStaticLane(lane)) {
+			vecStaticLanes.push_back(lane);
+			nLayerHeight = std::max(nLayerHeight, (lane.GetLaneID() + 1) * app->nCellSize);
+		}
+	}
+	if (vecStaticLanes.empty()) {
+		return 0;
+	}
+
+	pStaticLayer = std::make_shared<app::Sprite>(app->nLaneWidth * app->nCellSize, nLayerHeight);
+	app->SetDrawTarget(pStaticLayer.get());
+	for (const cMapLane& lane : vecStaticLanes) {
+		DrawLane(lane);
+		mapLaneStrips[lane.GetLaneID()].bStatic = true;
+		nStaticLanes++;
+	}
+	app->SetDrawTarget(nullptr);
+	return nStaticLanes;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// GETTERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Check if the pixels and collision zones of a lane can never change: the lane does not move,
+///        and none of its cells is animated, revealed near the player or can summon another object
+/// @param Lane Lane to be checked
+/// @return True if the lane is static, false otherwise
+bool hMapDrawer::IsStaticLane(const cMapLane& Lane) const
+{
+	if (Lane.GetVelocity() != 0.0f) {
+		return false;
+	}
+	for (const char graphic : Lane.GetLane()) {
+		const MapObject sprite = app->MapLoader.GetSpriteData(graphic);
+		if (sprite.nID > 0 || sprite.nRevealRadius > 0 || (sprite.summon != 0 && sprite.fChance > 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+/// @brief Getter for the number of lanes drawn from the static layer
+int hMapDrawer::GetStaticLaneCount() const
+{
+	return nStaticLanes;
+}
+/// @brief Show how many lanes of the level are drawn from the static layer, for the window title
+std::string hMapDrawer::ShowStaticLanes() const
+{
+	return "[Static lanes: " + std::to_string(GetStaticLaneCount()) + "/" + std::to_string(app->MapLoader.GetLanes().size()) + "]";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// DRAWERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 /// @brief Draw lane on screen
 /// @param lane Lane to be drawn
 /// @return True if successful, false otherwise
 bool hMapDrawer::DrawLane(const cMapLane& Lane) const
 {
-	std::vector<GraphicCell> Backgrounds = GetLaneBackgrounds(Lane);
-	for (const GraphicCell& BackgroundCell : Backgrounds) {
-		DrawBackground(BackgroundCell);
+	const int nStartPos = Lane.GetStartPos(app->fTimeSinceStart);
+	const int nCellOffset = Lane.GetCellOffset(app->nCellSize, app->fTimeSinceStart);
+	const int nPosY = Lane.GetLaneID() * app->nCellSize;
+	const int nLaneEndX = app->nLaneWidth * app->nCellSize;
+
+	// Static lanes are copied row by row, their collision zones were filled by BuildStaticLayer()
+	LaneStrip& Strip = GetLaneStrip(Lane);
+	if (Strip.bStatic && pStaticLayer) {
+		app->SetDrawLayer(app_const::LAYER_LANE_BACKGROUND);
+		app->SetPixelMode(app::Pixel::NORMAL);
+		app->DrawPartialSprite(0, nPosY, pStaticLayer.get(), 0, nPosY, nLaneEndX, app->nCellSize);
+		return true;
 	}
 
+	// Backgrounds scroll cell by cell, objects scroll pixel by pixel (cells -1 .. nLaneWidth - 1 are on screen)
+	// The object strip may be rendered here, which resets the pixel mode, so it is fetched first
+	const app::Sprite* pObjects = GetLaneObjectStrip(Strip, Lane);
+	app->SetDrawLayer(app_const::LAYER_LANE_BACKGROUND);
+	app->SetPixelMode(app::Pixel::NORMAL);
+	DrawLaneBackground(Strip.pBackground.get(), pObjects, nPosY, nStartPos * app->nCellSize, nStartPos * app->nCellSize + nCellOffset, nLaneEndX - nCellOffset, nLaneEndX);
+	app->SetDrawLayer(app_const::LAYER_LANE_OBJECT);
+	app->SetPixelMode(app::Pixel::MASK);
+	DrawLaneStrip(pObjects, nPosY, nStartPos * app->nCellSize + nCellOffset, -app->nCellSize - nCellOffset, nLaneEndX - nCellOffset);
+	app->SetPixelMode(app::Pixel::NORMAL);
+	DrawRevealedObjects(Lane, Strip, nStartPos, nCellOffset);
+	DrawBlendedObjects(Lane, Strip, nStartPos, nCellOffset);
+	app->SetDrawLayer(app_const::LAYER_SUMMON);
+
+	// Collision zones still follow every cell (revealed or not), summoned objects are drawn on top of the strips
+	const size_t nCells = static_cast<size_t>(app->nLaneWidth + 1);
 	std::vector<GraphicCell> Objects = GetLaneObjects(Lane);
-	for (const GraphicCell& ObjectCell : Objects) {
-		DrawObject(ObjectCell);
+	for (size_t id = 0; id < Objects.size(); ++id) {
+		if (id < nCells) {
+			FillZone(Objects[id]);
+		}
+		else {
+			DrawObject(Objects[id]);
+		}
+	}
+
+	return true;
+}
+/// @brief Draw the visible window of a lane strip
+/// @param pStrip Periodic strip of the lane
+/// @param nPosY Y-coordinate of the lane on screen
+/// @param nShift Strip column shown at screen column 0
+/// @param nBeginX First screen column covered by the lane
+/// @param nEndX One past the last screen column covered by the lane
+/// @return True if anything was drawn, false otherwise
+bool hMapDrawer::DrawLaneStrip(const app::Sprite* pStrip, const int nPosY, const int nShift, const int nBeginX, const int nEndX) const
+{
+	const int nFirstX = std::max(nBeginX, 0);
+	if (pStrip == nullptr || nFirstX >= nEndX) {
+		return false;
+	}
+	int nSrcX = (nFirstX + nShift) % pStrip->Width();
+	if (nSrcX < 0) {
+		nSrcX += pStrip->Width();
+	}
+	app->DrawPartialSprite(nFirstX, nPosY, pStrip, nSrcX, 0, nEndX - nFirstX, pStrip->Height());
+	return true;
+}
+/// @brief Draw the visible window of a lane background strip, except the columns hidden below opaque objects
+/// @param pBackground Periodic background strip of the lane
+/// @param pObjects Periodic object strip of the lane, drawn on top afterwards (may be nullptr)
+/// @param nPosY Y-coordinate of the lane on screen
+/// @param nShift Background strip column shown at screen column 0
+/// @param nObjectShift Object strip column shown at screen column 0
+/// @param nObjectEndX One past the last screen column covered by the object strip
+/// @param nEndX One past the last screen column covered by the lane
+/// @return True if anything was drawn, false otherwise
+bool hMapDrawer::DrawLaneBackground(const app::Sprite* pBackground, const app::Sprite* pObjects, const int nPosY, const int nShift, const int nObjectShift, const int nObjectEndX, const int nEndX) const
+{
+	if (pBackground == nullptr) {
+		return false;
+	}
+	if (pObjects == nullptr || !pObjects->HasOpaqueRuns()) {
+		return DrawLaneStrip(pBackground, nPosY, nShift, -app->nCellSize, nEndX);
+	}
+
+	// Draw the spans between the object columns that are opaque over the whole lane height
+	const int nObjectWidth = pObjects->Width();
+	int nObjectX = nObjectShift % nObjectWidth;
+	if (nObjectX < 0) {
+		nObjectX += nObjectWidth;
+	}
+	bool bDrawn = false;
+	int nSpanX = 0;
+	for (int x = 0; x < nEndX; x++) {
+		if (x < nObjectEndX && pObjects->IsOpaqueColumn(nObjectX)) {
+			bDrawn |= DrawLaneStrip(pBackground, nPosY, nShift, nSpanX, x);
+			nSpanX = x + 1;
+		}
+		if (++nObjectX == nObjectWidth) {
+			nObjectX = 0;
+		}
+	}
+	bDrawn |= DrawLaneStrip(pBackground, nPosY, nShift, nSpanX, nEndX);
+	return bDrawn;
+}
+
+/// @brief Fade in the objects of a lane that are only visible near the player. Only the columns whose
+///        centre is within the largest reveal radius of the lane are visited, the other cells keep the
+///        background drawn from the strip.
+/// @param Lane Lane to be drawn
+/// @param Strip Strips of the lane
+/// @param nStartPos Lane position shown at column 0
+/// @param nCellOffset Scrolling offset of the lane (in pixels)
+/// @return True if any object was drawn, false otherwise
+bool hMapDrawer::DrawRevealedObjects(const cMapLane& Lane, const LaneStrip& Strip, const int nStartPos, const int nCellOffset) const
+{
+	const int nRadius = Strip.nRevealRadius;
+	if (nRadius <= 0) {
+		return false;
+	}
+	const float fCellSize = static_cast<float>(app->nCellSize);
+	const float fPlayerX = (app->Player.GetPlayerAnimationPositionX() + 0.5f) * fCellSize;
+	const float fPlayerY = (app->Player.GetPlayerAnimationPositionY() + 0.5f) * fCellSize;
+	const int32_t nPosY = Lane.GetLaneID() * app->nCellSize;
+	const float fDistY = static_cast<float>(nPosY) + 0.5f * fCellSize - fPlayerY;
+	const float fReach2 = static_cast<float>(nRadius * nRadius) - fDistY * fDistY;
+	if (fReach2 <= 0.0f) {
+		return false;
+	}
+
+	// Column nCol is centred at nCol * nCellSize - nCellOffset + nCellSize / 2
+	const float fReach = std::sqrt(fReach2);
+	const float fCenterCol = (fPlayerX + static_cast<float>(nCellOffset)) / fCellSize - 0.5f;
+	const int nFirstCol = std::max(-1, static_cast<int>(std::floor(fCenterCol - fReach / fCellSize)));
+	const int nLastCol = std::min(app->nLaneWidth - 1, static_cast<int>(std::ceil(fCenterCol + fReach / fCellSize)));
+	bool bDrawn = false;
+	for (int nCol = nFirstCol; nCol <= nLastCol; nCol++) {
+		const MapObject sprite = app->MapLoader.GetSpriteData(Lane.GetLaneGraphic(nStartPos + nCol));
+		if (sprite.nRevealRadius > 0) {
+			bDrawn |= DrawRevealedObject(sprite, nCol * app->nCellSize - nCellOffset, nPosY);
+		}
+	}
+	return bDrawn;
+}
+/// @brief Draw an object revealed near the player, with an opacity falling off with the distance
+/// @param sprite Sprite data of the object
+/// @param nPosX X-coordinate of the cell on screen
+/// @param nPosY Y-coordinate of the cell on screen
+/// @return True if the object is close enough to be drawn, false otherwise
+bool hMapDrawer::DrawRevealedObject(const MapObject& sprite, const int32_t nPosX, const int32_t nPosY) const
+{
+	const uint8_t uAlpha = GetRevealAlpha(GetPlayerDistance2(nPosX, nPosY), sprite.nRevealRadius);
+	if (uAlpha == 0 || sprite.sSpriteName.empty()) {
+		return false;
+	}
+	if (sprite.eBlendMode != app::Pixel::MASK) { // Light effects already weight the sprite by its alpha
+		return DrawBlendedObject(sprite, nPosX, nPosY, static_cast<float>(uAlpha) / 255.0f);
 	}
+	const std::string sName = sprite.sSpriteName + (sprite.nID <= 0 ? "" : app->ShowFrameID(sprite.nID));
+	const app::Sprite* object = GetRevealSprite(sName);
+	if (object == nullptr) {
+		return false;
+	}
+	const int32_t nDrawX = sprite.nSpritePosX * app_const::SPRITE_WIDTH;
+	const int32_t nDrawY = sprite.nSpritePosY * app_const::SPRITE_HEIGHT;
+	const int nFlip = (sprite.isFlippedX ? app::Sprite::HORIZONTAL : 0) | (sprite.isFlippedY ? app::Sprite::VERTICAL : 0);
+	app->SetPixelMode(app::Pixel::PREMULTIPLIED);
+	app->SetBlendFactor(static_cast<float>(uAlpha) / 255.0f);
+	app->DrawPartialSprite(nPosX, nPosY, object, nDrawX, nDrawY, static_cast<app::Sprite::Flip>(nFlip));
+	app->SetBlendFactor(1.0f);
+	app->SetPixelMode(app::Pixel::NORMAL);
+	return true;
+}
 
+/// @brief Draw the objects of a lane that have their own pixel mode (light effects), cell by cell over the strips
+/// @param Lane Lane to be drawn
+/// @param Strip Strips of the lane
+/// @param nStartPos Lane position shown at column 0
+/// @param nCellOffset Scrolling offset of the lane (in pixels)
+/// @return True if any object was drawn, false otherwise
+bool hMapDrawer::DrawBlendedObjects(const cMapLane& Lane, const LaneStrip& Strip, const int nStartPos, const int nCellOffset) const
+{
+	if (!Strip.bBlended) {
+		return false;
+	}
+	const int32_t nPosY = Lane.GetLaneID() * app->nCellSize;
+	bool bDrawn = false;
+	for (int nCol = -1; nCol < app->nLaneWidth; nCol++) {
+		const MapObject sprite = app->MapLoader.GetSpriteData(Lane.GetLaneGraphic(nStartPos + nCol));
+		if (sprite.eBlendMode != app::Pixel::MASK && sprite.nRevealRadius <= 0) {
+			bDrawn |= DrawBlendedObject(sprite, nCol * app->nCellSize - nCellOffset, nPosY);
+		}
+	}
+	return bDrawn;
+}
+/// @brief Draw an object with its own pixel mode (see MapObject::eBlendMode)
+/// @param sprite Sprite data of the object
+/// @param nPosX X-coordinate of the cell on screen
+/// @param nPosY Y-coordinate of the cell on screen
+/// @param fBlendFactor Strength of the effect (0.0-1.0)
+/// @return True if the object has a sprite, false otherwise
+bool hMapDrawer::DrawBlendedObject(const MapObject& sprite, const int32_t nPosX, const int32_t nPosY, const float fBlendFactor) const
+{
+	if (sprite.sSpriteName.empty()) {
+		return false;
+	}
+	const std::string sName = sprite.sSpriteName + (sprite.nID <= 0 ? "" : app->ShowFrameID(sprite.nID));
+	const app::Sprite* object = cAssetManager::GetInstance().GetSprite(sName);
+	const int32_t nDrawX = sprite.nSpritePosX * app_const::SPRITE_WIDTH;
+	const int32_t nDrawY = sprite.nSpritePosY * app_const::SPRITE_HEIGHT;
+	const int nFlip = (sprite.isFlippedX ? app::Sprite::HORIZONTAL : 0) | (sprite.isFlippedY ? app::Sprite::VERTICAL : 0);
+	app->SetPixelMode(sprite.eBlendMode);
+	app->SetBlendFactor(fBlendFactor);
+	app->DrawPartialSprite(nPosX, nPosY, object, nDrawX, nDrawY, static_cast<app::Sprite::Flip>(nFlip));
+	app->SetBlendFactor(1.0f);
+	app->SetPixelMode(app::Pixel::NORMAL);
 	return true;
 }
 
-/// @brief Draw all lanes on screen
+/// @brief Draw all lanes on screen, clipped to the playfield (the last lane columns are under the status bar)
 /// @return Always true by default
 bool hMapDrawer::DrawAllLanes() const
 {
 	const std::vector<cMapLane> vecLanes = app->MapLoader.GetLanes();
+	app->PushClipRect(0, 0, app_const::FIELD_WIDTH, app_const::FIELD_HEIGHT);
 	for (const cMapLane& lane : vecLanes) {
 		DrawLane(lane);
 	}
+	app->PopClipRect();
 
 	return true;
 }
@@ -156,11 +596,20 @@ bool hMapDrawer::DrawObject(const GraphicCell& Cell) const
 	const int32_t nDrawX = sprite.nSpritePosX * app_const::SPRITE_WIDTH;
 	const int32_t nDrawY = sprite.nSpritePosY * app_const::SPRITE_HEIGHT;
 	const std::string sName = sprite.sSpriteName + (sprite.nID <= 0 ? "" : app->ShowFrameID(sprite.nID));
+	const int nFlip = (sprite.isFlippedX ? app::Sprite::HORIZONTAL : 0) | (sprite.isFlippedY ? app::Sprite::VERTICAL : 0);
 	if (sName.size()) {
-		const app::Sprite* object = cAssetManager::GetInstance().GetSprite(sName);
-		app->SetPixelMode(app::Pixel::MASK);
-		app->DrawPartialSprite(nPosX, nPosY, object, nDrawX, nDrawY);
-		app->SetPixelMode(app::Pixel::NORMAL);
+		if (sprite.nRevealRadius > 0) {
+			DrawRevealedObject(sprite, nPosX, nPosY);
+		}
+		else if (sprite.eBlendMode != app::Pixel::MASK) {
+			DrawBlendedObject(sprite, nPosX, nPosY);
+		}
+		else {
+			const app::Sprite* object = cAssetManager::GetInstance().GetSprite(sName);
+			app->SetPixelMode(app::Pixel::MASK);
+			app->DrawPartialSprite(nPosX, nPosY, object, nDrawX, nDrawY, static_cast<app::Sprite::Flip>(nFlip));
+			app->SetPixelMode(app::Pixel::NORMAL);
+		}
 
 		app->Zone.FillDanger(Cell.graphic, nPosX, nPosY);
 		app->Zone.FillBlocked(Cell.graphic, nPosX, nPosY);
@@ -168,26 +617,19 @@ bool hMapDrawer::DrawObject(const GraphicCell& Cell) const
 	return true;
 }
 
-/// @brief Draw background on screen
-/// @param Cell Graphic cell to be drawn
-/// @return Always true by default
-bool hMapDrawer::DrawBackground(const GraphicCell& Cell) const
+/// @brief Fill the collision zone of a cell
+/// @param Cell Graphic cell to be filled
+/// @return True if the cell has a sprite or a background, false otherwise
+bool hMapDrawer::FillZone(const GraphicCell& Cell) const
 {
 	const MapObject sprite = app->MapLoader.GetSpriteData(Cell.graphic);
+	if (sprite.sSpriteName.empty() && sprite.nID <= 0 && sprite.sBackgroundName.empty()) {
+		return false;
+	}
 	const int32_t nPosX = Cell.nCol * app->nCellSize - Cell.nCellOffset;
 	const int32_t nPosY = Cell.nRow * app->nCellSize;
-	const int32_t nDrawX = sprite.nBackgroundPosX * app_const::SPRITE_WIDTH;
-	const int32_t nDrawY = sprite.nBackgroundPosY * app_const::SPRITE_HEIGHT;
-	const std::string sName = sprite.sBackgroundName;
-	if (sName.size()) {
-		const app::Sprite* background = cAssetManager::GetInstance().GetSprite(sName);
-		app->SetPixelMode(app::Pixel::NORMAL);
-		app->DrawPartialSprite(nPosX + Cell.nCellOffset, nPosY, background, nDrawX, nDrawY);
-		app->SetPixelMode(app::Pixel::NORMAL);
-
-		app->Zone.FillDanger(Cell.graphic, nPosX, nPosY);
-		app->Zone.FillBlocked(Cell.graphic, nPosX, nPosY);
-	}
+	app->Zone.FillDanger(Cell.graphic, nPosX, nPosY);
+	app->Zone.FillBlocked(Cell.graphic, nPosX, nPosY);
 	return true;
 }
 
@@ -9,6 +9,10 @@
 #include "cMapLane.h"
 #include "cMapObject.h"
 #include "cMapObject.h"
+#include "gSprite.h"
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 // Forward declaration
@@ -29,11 +33,27 @@ struct GraphicCell
 	~GraphicCell();
 };
 
+/// @brief Lane pre-rendered into strips of one lane period, scrolled by blitting a window of them
+struct LaneStrip
+{
+	std::string sLane;                                      ///< Lane content the strips were rendered from
+	std::vector<int> vecFrames;                             ///< Animation frames (MapObject::nID) used by the lane objects
+	std::shared_ptr<app::Sprite> pBackground;               ///< Backgrounds of all cells (nullptr if the lane has none)
+	std::map<int, std::shared_ptr<app::Sprite>> mapObjects; ///< Objects of all cells, per animation frame key
+	bool bStatic = false;                                   ///< If the lane is drawn from the static layer
+	int nRevealRadius = 0;                                  ///< Largest reveal radius of the lane objects, 0 if all are always visible
+	bool bBlended = false;                                  ///< If some lane objects are drawn with their own pixel mode instead of from the object strip
+};
+
 /// @brief Class for drawing map on screen
 class hMapDrawer
 {
 private:
 	cApp* app;
+	mutable std::map<int, LaneStrip> mapLaneStrips; ///< Pre-rendered lanes by lane ID, rebuilt when the lane changes
+	std::shared_ptr<app::Sprite> pStaticLayer;      ///< Final pixels of the static lanes, at their screen position
+	int nStaticLanes;                               ///< Number of lanes drawn from the static layer
+	mutable std::map<std::string, std::shared_ptr<app::Sprite>> mapRevealSprites; ///< Premultiplied copies of the objects faded in near the player
 
 public: // Constructors & Destructor
 	hMapDrawer();
@@ -44,13 +64,36 @@ public: // Setters
 	bool SetupTarget(cApp* app);
 
 private: /// Internality
-	std::vector<GraphicCell> GetLaneBackgrounds(const cMapLane& Lane) const;
 	std::vector<GraphicCell> GetLaneObjects(const cMapLane& Lane) const;
+	LaneStrip& GetLaneStrip(const cMapLane& Lane) const;
+	const app::Sprite* GetLaneObjectStrip(LaneStrip& Strip, const cMapLane& Lane) const;
+	int GetFrameKey(const LaneStrip& Strip) const;
+	const app::Sprite* GetRevealSprite(const std::string& sName) const;
+	int GetPlayerDistance2(int32_t nPosX, int32_t nPosY) const;
+	static uint8_t GetRevealAlpha(int nDistance2, int nRadius);
+
+private: // Pre-renderers
+	std::shared_ptr<app::Sprite> RenderLaneStrip(const cMapLane& Lane, bool bObjects) const;
+
+public: // Pre-renderers
+	bool BuildLaneStrips();
+	int BuildStaticLayer();
+
+public: // Getters
+	bool IsStaticLane(const cMapLane& Lane) const;
+	int GetStaticLaneCount() const;
+	std::string ShowStaticLanes() const;
 
 private: // Drawer helpers
 	bool DrawLane(const cMapLane& Lane) const;
+	bool DrawLaneStrip(const app::Sprite* pStrip, int nPosY, int nShift, int nBeginX, int nEndX) const;
+	bool DrawLaneBackground(const app::Sprite* pBackground, const app::Sprite* pObjects, int nPosY, int nShift, int nObjectShift, int nObjectEndX, int nEndX) const;
 	bool DrawObject(const GraphicCell& Cell) const;
-	bool DrawBackground(const GraphicCell& Cell) const;
+	bool DrawRevealedObjects(const cMapLane& Lane, const LaneStrip& Strip, int nStartPos, int nCellOffset) const;
+	bool DrawRevealedObject(const MapObject& sprite, int32_t nPosX, int32_t nPosY) const;
+	bool DrawBlendedObjects(const cMapLane& Lane, const LaneStrip& Strip, int nStartPos, int nCellOffset) const;
+	bool DrawBlendedObject(const MapObject& sprite, int32_t nPosX, int32_t nPosY, float fBlendFactor = 1.0f) const;
+	bool FillZone(const GraphicCell& Cell) const;
 
 public: // Drawers
 	bool DrawAllLanes() const;
@@ -99,6 +99,17 @@ bool hMenu::OpenMenu()
 	return true;
 }
 
+/// @brief Skip the menu and play the current level, for headless runs without input
+/// @return Always return true by default
+bool hMenu::StartGame()
+{
+	ResetMenu();
+	CloseMenu();
+	eMenuOption = AppOption::APP_GAME;
+	app->GameReset();
+	return true;
+}
+
 /// @brief Load option and draw it on screen
 /// @param app Pointer to application
 /// @return Always return true by default
@@ -401,16 +412,12 @@ bool hMenu::RenderAppExit() const
 /// @return Always return true by default
 bool hMenu::RenderPausing() const
 {
-	/// Overlay
-	app->SetPixelMode(app::Pixel::ALPHA);
-	app->SetBlendFactor(170.0f / 255.0f);
+	/// Overlay (premultiplied at load, its own alpha darkens the game render)
+	app->SetPixelMode(app::Pixel::PREMULTIPLIED);
 	app->DrawSprite(0, 0, cAssetManager::GetInstance().GetSprite("black_alpha"));
-	app->SetBlendFactor(255.0f / 255.0f);
-	app->SetPixelMode(app::Pixel::NORMAL);
 	/// Pause Selection
 	const std::string sSelectedLabel = sPauseOptionLabels[nPauseOptionValue];
 	const std::string sOptionName = "pause_" + sSelectedLabel;
-	app->SetPixelMode(app::Pixel::MASK);
 	app->DrawSprite(120, 55, cAssetManager::GetInstance().GetSprite(sOptionName));
 	app->SetPixelMode(app::Pixel::NORMAL);
 	return true;
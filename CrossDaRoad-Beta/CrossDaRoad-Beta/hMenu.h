@@ -72,6 +72,7 @@ public: // Initialization & Clean-up
 
 public: // Managements
 	bool OpenMenu();
+	bool StartGame();
 
 private: // Management helpers
 	bool LoadAppOption();
@@ -695,30 +695,6 @@ bool hPlayer::OnUpdatePlayerJumpStop()
 ///////////////////////////////////////// PLAYER RENDERER ///////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool hPlayer::OnRenderPlayerIdle() const
-{
-	OnRenderPlayer();
-	return true;
-}
-
-bool hPlayer::OnRenderPlayerJumpStart() const
-{
-	OnRenderPlayer();
-	return true;
-}
-
-bool hPlayer::OnRenderPlayerJumpContinue() const
-{
-	OnRenderPlayer();
-	return true;
-}
-
-bool hPlayer::OnRenderPlayerJumpStop() const
-{
-	OnRenderPlayer();
-	return true;
-}
-
 /// @brief Render player animation to screen
 /// @return Always true by default
 bool hPlayer::OnRenderPlayer() const
@@ -728,19 +704,20 @@ bool hPlayer::OnRenderPlayer() const
 	const bool isLeft = (IsLeftDirection());
 	const bool isJump = (IsPlayerJumping()) && (isValidID);
 	const std::string froggy_state = std::string(isJump ? "_jump" : "");
-	const std::string froggy_direction = std::string(isLeft ? "_left" : "");
 	const std::string froggy_id = (isJump ? std::to_string(nID) : "");
-	const std::string froggy_name = "froggy" + froggy_state + froggy_direction + froggy_id;
+	const std::string froggy_name = "froggy" + froggy_state + froggy_id;
+	const app::Sprite::Flip froggy_flip = (isLeft ? app::Sprite::HORIZONTAL : app::Sprite::NONE);
 	const auto froggy = cAssetManager::GetInstance().GetSprite(froggy_name);
 	if (froggy == nullptr) {
 		std::cerr << "WTF, cant found " << froggy_name << std::endl;
 	}
 
+	app->SetDrawLayer(app_const::LAYER_PLAYER);
 	app->SetPixelMode(app::Pixel::MASK);
 	const float nCellSize = static_cast<float>(app->nCellSize);
 	const int32_t frogXPosition = static_cast<int32_t>(fFrogAnimPosX * nCellSize);
 	const int32_t frogYPosition = static_cast<int32_t>(fFrogAnimPosY * nCellSize);
-	app->DrawSprite(frogXPosition, frogYPosition, froggy);
+	app->DrawSprite(frogXPosition, frogYPosition, froggy, 1, froggy_flip);
 	app->SetPixelMode(app::Pixel::NORMAL);
 	return true;
 }
@@ -763,6 +740,7 @@ bool hPlayer::OnRenderPlayerDeath()
 		app->SetPixelMode(app::Pixel::MASK);
 		app->DrawSprite(frogXPosition, frogYPosition, froggy);
 		app->SetPixelMode(app::Pixel::NORMAL);
+		app->VisibilityMask.Apply();
 		app->DrawStatusBar();
 
 		app->RenderTexture();
@@ -776,7 +754,7 @@ bool hPlayer::OnRenderPlayerDeath()
 ///////////////////////////////////////// LOGIC-RENDER CONTROL /////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// @brief Update player animation and render to screen
+/// @brief Update player animation, the player is rendered by cApp::OnGameRender()
 /// @return Always true by default
 bool hPlayer::OnPlayerMove()
 {
@@ -800,21 +778,15 @@ bool hPlayer::OnPlayerMove()
 
 		if (IsPlayerJumping()) {
 			OnUpdatePlayerJumpStart();
-			OnRenderPlayerJumpStart();
-		}
-		else {
-			OnRenderPlayerIdle();
 		}
 		return true;
 	}
 
 	if (!IsPlayerLanding()) {
 		OnUpdatePlayerJumpContinue();
-		OnRenderPlayerJumpContinue();
 	}
 	else { /// Jump completed
 		OnUpdatePlayerJumpStop();
-		OnRenderPlayerJumpStop();
 	}
 	return true;
 }
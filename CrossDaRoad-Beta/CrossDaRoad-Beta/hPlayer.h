@@ -157,12 +157,6 @@ private: // Logic Updater
 	bool OnUpdatePlayerJumpContinue();
 	bool OnUpdatePlayerJumpStop();
 
-private: // Player Renderer 
-	bool OnRenderPlayerIdle() const;
-	bool OnRenderPlayerJumpStart() const;
-	bool OnRenderPlayerJumpContinue() const;
-	bool OnRenderPlayerJumpStop() const;
-
 public: // Player Renderers
 	bool OnRenderPlayer() const;
 	bool OnRenderPlayerDeath();
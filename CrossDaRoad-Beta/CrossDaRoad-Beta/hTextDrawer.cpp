@@ -0,0 +1,188 @@
+/**
+ * @file hTextDrawer.cpp
+ * @brief Implements text drawer class for drawing bitmap font text on screen
+ *
+**/
+
+#include "hTextDrawer.h"
+#include "cApp.h"
+#include <algorithm>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////// CONSTRUCTORS & DESTRUCTOR /////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor
+hTextDrawer::hTextDrawer()
+{
+	app = nullptr;
+	pFont = nullptr;
+}
+
+/// @brief Parameterized constructor
+/// @param app Pointer to the application
+hTextDrawer::hTextDrawer(cApp* app)
+{
+	pFont = nullptr;
+	SetupTarget(app);
+}
+
+/// @brief Destructor
+hTextDrawer::~hTextDrawer()
+{
+	app = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// SETTERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Setup target application
+/// @param app Pointer to the application
+/// @return True if application is not null, false otherwise
+bool hTextDrawer::SetupTarget(cApp* app)
+{
+	if (app == nullptr) {
+		std::cerr << "hTextDrawer::SetupTarget(cApp* app): app is nullptr" << std::endl;
+		return false;
+	}
+	this->app = app;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////// INTERNALITY ///////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Resolve the font sprite once, then compute the glyph positions and its opaque runs
+/// @return True if the font is loaded, false otherwise
+bool hTextDrawer::LoadFont() const
+{
+	if (pFont) {
+		return true;
+	}
+	app::Sprite* pSprite = cAssetManager::GetInstance().GetSprite("font");
+	if (pSprite == nullptr || pSprite->Width() < app_const::FONT_WIDTH) {
+		std::cerr << "hTextDrawer::LoadFont(): font sprite is not loaded" << std::endl;
+		return false;
+	}
+
+	// Glyphs are laid out row by row, as many per row as the font sprite fits
+	const int nGlyphsInRow = pSprite->Width() / app_const::FONT_WIDTH;
+	for (int nGlyph = 0; nGlyph < GLYPH_COUNT; nGlyph++) {
+		glyphs[nGlyph].nPosX = (nGlyph % nGlyphsInRow) * app_const::FONT_WIDTH;
+		glyphs[nGlyph].nPosY = (nGlyph / nGlyphsInRow) * app_const::FONT_HEIGHT;
+	}
+	pSprite->BuildOpaqueRuns(); // Glyph runs drawn in Pixel::MASK mode only copy the opaque spans
+	pFont = pSprite;
+	return true;
+}
+
+/// @brief Check if a character has a glyph in the font
+/// @param c The character
+bool hTextDrawer::IsGlyph(const char c) const
+{
+	const int nGlyph = static_cast<unsigned char>(c) - FIRST_GLYPH;
+	if (nGlyph < 0 || nGlyph >= GLYPH_COUNT) {
+		return false;
+	}
+	const GlyphRect& glyph = glyphs[nGlyph];
+	return glyph.nPosX + app_const::FONT_WIDTH <= pFont->Width() && glyph.nPosY + app_const::FONT_HEIGHT <= pFont->Height();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////// PRE-RENDERERS //////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Render a string into a sprite of its size, by copying the glyph rows from the font
+/// @param sText The string to render
+/// @return Sprite of the string with its opaque runs built, nullptr if the string is empty
+std::shared_ptr<app::Sprite> hTextDrawer::RenderText(const std::string& sText) const
+{
+	if (sText.empty()) {
+		return nullptr;
+	}
+
+	const int nWidth = static_cast<int>(sText.size()) * app_const::FONT_WIDTH;
+	const auto pText = std::make_shared<app::Sprite>(nWidth, app_const::FONT_HEIGHT);
+	std::fill_n(pText->GetData(), pText->Width() * pText->Height(), app::BLANK);
+	for (size_t i = 0; i < sText.size(); i++) {
+		if (!IsGlyph(sText[i])) {
+			continue;
+		}
+		const GlyphRect& glyph = glyphs[static_cast<unsigned char>(sText[i]) - FIRST_GLYPH];
+		for (int y = 0; y < app_const::FONT_HEIGHT; y++) {
+			app::Pixel* pDst = pText->GetData() + y * nWidth + static_cast<int>(i) * app_const::FONT_WIDTH;
+			for (int x = 0; x < app_const::FONT_WIDTH; x++) {
+				pDst[x] = pFont->GetPixel(glyph.nPosX + x, glyph.nPosY + y); // The font may be stored indexed
+			}
+		}
+	}
+	pText->BuildOpaqueRuns();
+	return pText;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// GETTERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Getter for the number of rendered strings
+size_t hTextDrawer::GetCachedTextCount() const
+{
+	return mapTexts.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// DRAWERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Draw a string glyph by glyph from the font, with the current pixel mode
+/// @param sText The string to draw
+/// @param nPosX X-coordinate of the string on screen
+/// @param nPosY Y-coordinate of the string on screen
+/// @return False if the font is not loaded, true otherwise
+bool hTextDrawer::DrawGlyphRun(const std::string& sText, const int nPosX, const int nPosY) const
+{
+	if (!LoadFont()) {
+		return false;
+	}
+	for (size_t i = 0; i < sText.size(); i++) {
+		if (!IsGlyph(sText[i])) {
+			continue;
+		}
+		const GlyphRect& glyph = glyphs[static_cast<unsigned char>(sText[i]) - FIRST_GLYPH];
+		const int nDrawX = nPosX + static_cast<int>(i) * app_const::FONT_WIDTH;
+		app->DrawPartialSprite(nDrawX, nPosY, pFont, glyph.nPosX, glyph.nPosY, app_const::FONT_WIDTH, app_const::FONT_HEIGHT);
+	}
+	return true;
+}
+
+/// @brief Draw a string with the current pixel mode, from its rendered sprite when it was drawn before
+/// @param sText The string to draw
+/// @param nPosX X-coordinate of the string on screen
+/// @param nPosY Y-coordinate of the string on screen
+/// @return False if the font is not loaded, true otherwise
+bool hTextDrawer::DrawString(const std::string& sText, const int nPosX, const int nPosY) const
+{
+	if (!LoadFont()) {
+		return false;
+	}
+
+	// Rendered strings are kept alive, since recorded draw commands may still point to them this frame
+	auto it = mapTexts.find(sText);
+	if (it == mapTexts.end()) {
+		if (mapTexts.size() >= MAX_CACHED_TEXTS) {
+			return DrawGlyphRun(sText, nPosX, nPosY);
+		}
+		it = mapTexts.emplace(sText, RenderText(sText)).first;
+	}
+	if (it->second) {
+		app->DrawSprite(nPosX, nPosY, it->second.get());
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////// END OF FILE ///////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
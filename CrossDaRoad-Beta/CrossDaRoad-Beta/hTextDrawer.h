@@ -0,0 +1,61 @@
+/**
+ * @file hTextDrawer.h
+ * @brief Contains text drawer class for drawing bitmap font text on screen
+**/
+
+#ifndef H_TEXT_DRAWER_H
+#define H_TEXT_DRAWER_H
+
+#include "gSprite.h"
+#include <map>
+#include <memory>
+#include <string>
+
+// Forward declaration
+class cApp;
+
+/// @brief Class for drawing text with the bitmap font, caching the strings drawn every frame
+class hTextDrawer
+{
+public:
+	static constexpr int FIRST_GLYPH = 32;        ///< First character of the font (space)
+	static constexpr int GLYPH_COUNT = 96;        ///< Characters of the font, ASCII 32 .. 127
+	static constexpr size_t MAX_CACHED_TEXTS = 64; ///< Strings rendered once, later strings are drawn glyph by glyph
+
+private:
+	/// @brief Position of a glyph in the font sprite
+	struct GlyphRect
+	{
+		int nPosX; ///< X-coordinate of the glyph in the font sprite
+		int nPosY; ///< Y-coordinate of the glyph in the font sprite
+	};
+
+	cApp* app;
+	mutable const app::Sprite* pFont;                                        ///< Font sprite, resolved on the first draw
+	mutable GlyphRect glyphs[GLYPH_COUNT];                                   ///< Glyph positions by character - FIRST_GLYPH
+	mutable std::map<std::string, std::shared_ptr<app::Sprite>> mapTexts;   ///< Rendered strings, never evicted while drawing
+
+public: // Constructors & Destructor
+	hTextDrawer();
+	hTextDrawer(cApp* app);
+	~hTextDrawer();
+
+public: // Setters
+	bool SetupTarget(cApp* app);
+
+private: // Internality
+	bool LoadFont() const;
+	bool IsGlyph(char c) const;
+
+private: // Pre-renderers
+	std::shared_ptr<app::Sprite> RenderText(const std::string& sText) const;
+
+public: // Getters
+	size_t GetCachedTextCount() const;
+
+public: // Drawers
+	bool DrawGlyphRun(const std::string& sText, int nPosX, int nPosY) const;
+	bool DrawString(const std::string& sText, int nPosX, int nPosY) const;
+};
+
+#endif // H_TEXT_DRAWER_H
@@ -0,0 +1,170 @@
+/**
+ * @file hVisibilityMask.cpp
+ * @brief Implements visibility mask class for darkening the map around the player
+ *
+**/
+
+#include "hVisibilityMask.h"
+#include "cApp.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////// CONSTRUCTORS & DESTRUCTOR /////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Default constructor
+hVisibilityMask::hVisibilityMask()
+{
+	app = nullptr;
+	nCenterX = 0;
+	nCenterY = 0;
+	bOutdated = true;
+}
+
+/// @brief Parameterized constructor
+/// @param app Pointer to the application
+hVisibilityMask::hVisibilityMask(cApp* app)
+{
+	nCenterX = 0;
+	nCenterY = 0;
+	bOutdated = true;
+	SetupTarget(app);
+}
+
+/// @brief Destructor
+hVisibilityMask::~hVisibilityMask()
+{
+	app = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// SETTERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Setup target application
+/// @param app Pointer to the application
+/// @return True if application is not null, false otherwise
+bool hVisibilityMask::SetupTarget(cApp* app)
+{
+	if (app == nullptr) {
+		std::cerr << "hVisibilityMask::SetupTarget(cApp* app): app is nullptr" << std::endl;
+		return false;
+	}
+	this->app = app;
+	return true;
+}
+
+/// @brief Setter for the visibility of the current map, the falloff table is only recomputed when it changes
+/// @param visibility Visibility read from the map file
+void hVisibilityMask::SetVisibility(const MapVisibility& visibility)
+{
+	if (visibility == this->visibility) {
+		return;
+	}
+	this->visibility = visibility;
+	UpdateFalloff();
+	bOutdated = true;
+}
+
+/// @brief Setter for the centre of the visible area, the weights are only recomputed when it moves
+/// @param nPosX X-coordinate of the centre (in pixels)
+/// @param nPosY Y-coordinate of the centre (in pixels)
+void hVisibilityMask::SetCenter(const int nPosX, const int nPosY)
+{
+	if (nPosX == nCenterX && nPosY == nCenterY) {
+		return;
+	}
+	nCenterX = nPosX;
+	nCenterY = nPosY;
+	bOutdated = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// GETTERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Check if the current map is darkened at all
+bool hVisibilityMask::IsEnabled() const
+{
+	return visibility.nRadius > 0 && visibility.nAmbient < 255;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////// INTERNALITY ///////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Compute the weight of every squared distance inside the radius, fully lit inside the falloff edge
+///        then fading to the ambient brightness with a smoothstep
+void hVisibilityMask::UpdateFalloff()
+{
+	const int nRadius = visibility.nRadius;
+	const float fInner = static_cast<float>(nRadius - std::min(visibility.nFalloff, nRadius));
+	const float fEdge = static_cast<float>(nRadius) - fInner;
+	const float fAmbient = static_cast<float>(visibility.nAmbient);
+	vecFalloff.resize(static_cast<size_t>(nRadius) * nRadius);
+	for (size_t uDist2 = 0; uDist2 < vecFalloff.size(); uDist2++) {
+		const float fDist = std::sqrt(static_cast<float>(uDist2));
+		if (fDist <= fInner || fEdge <= 0.0f) {
+			vecFalloff[uDist2] = 255;
+			continue;
+		}
+		const float t = (static_cast<float>(nRadius) - fDist) / fEdge;
+		const float fWeight = fAmbient + (255.0f - fAmbient) * t * t * (3.0f - 2.0f * t);
+		vecFalloff[uDist2] = static_cast<uint8_t>(fWeight + 0.5f);
+	}
+}
+
+/// @brief Compute the weights of the masked area: rows and columns outside the radius are filled with the
+///        ambient brightness, only the square around the centre reads the falloff table
+void hVisibilityMask::UpdateWeights()
+{
+	const int nRadius = visibility.nRadius;
+	const int nRadius2 = nRadius * nRadius;
+	const uint8_t uAmbient = static_cast<uint8_t>(visibility.nAmbient);
+	vecWeights.resize(static_cast<size_t>(FIELD_WIDTH) * FIELD_HEIGHT);
+	const int nLeft = std::max(0, nCenterX - nRadius + 1);
+	const int nRight = std::min(FIELD_WIDTH, nCenterX + nRadius);
+	for (int y = 0; y < FIELD_HEIGHT; y++) {
+		uint8_t* pRow = vecWeights.data() + static_cast<size_t>(y) * FIELD_WIDTH;
+		const int nDistY = y - nCenterY;
+		if (nDistY <= -nRadius || nDistY >= nRadius || nLeft >= nRight) {
+			std::fill_n(pRow, FIELD_WIDTH, uAmbient);
+			continue;
+		}
+		std::fill(pRow, pRow + nLeft, uAmbient);
+		for (int x = nLeft; x < nRight; x++) {
+			const int nDist2 = (x - nCenterX) * (x - nCenterX) + nDistY * nDistY;
+			pRow[x] = (nDist2 < nRadius2) ? vecFalloff[nDist2] : uAmbient;
+		}
+		std::fill(pRow + nRight, pRow + FIELD_WIDTH, uAmbient);
+	}
+	bOutdated = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////// DRAWERS /////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Darken the map drawn so far around the centre, does nothing if the map sets no visibility
+/// @return True if the mask was applied or is not needed, false if there is no application
+bool hVisibilityMask::Apply()
+{
+	if (!IsEnabled()) {
+		return true;
+	}
+	if (app == nullptr) {
+		std::cerr << "hVisibilityMask::Apply(): app is nullptr" << std::endl;
+		return false;
+	}
+	if (bOutdated) {
+		UpdateWeights();
+	}
+	app->Modulate(0, 0, FIELD_WIDTH, FIELD_HEIGHT, vecWeights.data(), FIELD_WIDTH);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////// END OF FILE ///////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
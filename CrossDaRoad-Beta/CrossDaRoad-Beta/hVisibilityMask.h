@@ -0,0 +1,54 @@
+/**
+ * @file hVisibilityMask.h
+ * @brief Contains visibility mask class for darkening the map around the player
+**/
+
+#ifndef H_VISIBILITY_MASK_H
+#define H_VISIBILITY_MASK_H
+
+#include "cMapLoader.h"
+#include "uAppConst.h"
+#include <cstdint>
+#include <vector>
+
+// Forward declaration
+class cApp;
+
+/// @brief Class for darkening the map outside a radius around the player, on maps that set a visibility
+class hVisibilityMask
+{
+public:
+	static constexpr int FIELD_WIDTH = app_const::FIELD_WIDTH;   ///< Width of the masked area, the status bar is never darkened
+	static constexpr int FIELD_HEIGHT = app_const::FIELD_HEIGHT; ///< Height of the masked area
+
+private:
+	cApp* app;
+	MapVisibility visibility;        ///< Visibility the falloff table was computed for
+	std::vector<uint8_t> vecFalloff; ///< Weights by squared distance to the centre, up to the squared radius
+	std::vector<uint8_t> vecWeights; ///< Weights of the masked area, row by row
+	int nCenterX;                    ///< X-coordinate of the centre of the visible area (in pixels)
+	int nCenterY;                    ///< Y-coordinate of the centre of the visible area (in pixels)
+	bool bOutdated;                  ///< If the weights must be recomputed before the next Apply()
+
+public: // Constructors & Destructor
+	hVisibilityMask();
+	hVisibilityMask(cApp* app);
+	~hVisibilityMask();
+
+public: // Setters
+	bool SetupTarget(cApp* app);
+	void SetVisibility(const MapVisibility& visibility);
+	void SetCenter(int nPosX, int nPosY);
+
+public: // Getters
+	bool IsEnabled() const;
+
+private: // Internality
+	void UpdateFalloff();
+	void UpdateWeights();
+
+public: // Drawers
+	bool Apply();
+};
+
+#endif // H_VISIBILITY_MASK_H
@@ -1,10 +1,85 @@
 #include "cApp.h"
+#include "gHeadlessPresenter.h"
+#include "gRecorder.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
-int main()
+/// @brief Decode a recording frame by frame, optionally dumping every frame as PPM at window resolution
+/// @return 0 if the recording was opened, 1 otherwise
+static int PlayRecording(const std::string& sFilePath, const std::string& sDumpDirectory)
 {
+	app::RecordingPlayer player;
+	if (!player.Open(sFilePath)) {
+		return 1;
+	}
+	app::HeadlessPresenter presenter(sDumpDirectory, 1, app_const::PIXEL_WIDTH, app_const::PIXEL_HEIGHT);
+	const app::Sprite* pFrame = player.GetFrame();
+	if (!presenter.Create(nullptr, *pFrame, ViewportState())) {
+		return 1;
+	}
+	while (player.NextFrame()) {
+		presenter.Present(*pFrame, 0, 0, pFrame->Width(), pFrame->Height(), ViewportState());
+	}
+	std::cout << "Decoded " << player.GetFrameIndex() << " frames from " << sFilePath << std::endl;
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	// --play recording [dump_dir]: decode a recording made with --record, without running the game
+	if (argc > 2 && std::strcmp(argv[1], "--play") == 0) {
+		return PlayRecording(argv[2], argc > 3 ? argv[3] : "");
+	}
+
+	// --headless [dump_dir]: run without window nor GPU, optionally dumping every frame as PPM at window resolution
+	// --frames N: with --headless, render N frames as fast as possible without input, then exit
+	// --golden dir: with --headless, compare every frame with the ones dumped in dir by an earlier run
+	// --record file: record every rendered frame for QA
+	bool bHeadless = false;
+	std::string sDumpDirectory, sGoldenDirectory, sRecordFile;
+	uint32_t uFrames = 0;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--headless") == 0) {
+			bHeadless = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-') {
+				sDumpDirectory = argv[++i];
+			}
+		}
+		else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			uFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+			sGoldenDirectory = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			sRecordFile = argv[++i];
+		}
+	}
+
 	cApp app;
-	if (app.Construct(app_const::SCREEN_WIDTH, app_const::SCREEN_HEIGHT, app_const::PIXEL_WIDTH, app_const::PIXEL_HEIGHT) == engine::SUCCESS) {
-		app.Start();
+	if (app.Construct(app_const::SCREEN_WIDTH, app_const::SCREEN_HEIGHT, app_const::PIXEL_WIDTH, app_const::PIXEL_HEIGHT) != engine::SUCCESS) {
+		return 1;
+	}
+	app::HeadlessPresenter* pHeadless = nullptr; // Owned by the engine, which outlives this function's use of it
+	if (bHeadless) {
+		pHeadless = new app::HeadlessPresenter(sDumpDirectory, 1, app_const::PIXEL_WIDTH, app_const::PIXEL_HEIGHT);
+		pHeadless->SetGoldenDirectory(sGoldenDirectory);
+		app.SetPresenter(std::unique_ptr<app::Presenter>(pHeadless));
+	}
+	if (!app.SetFrameLimit(uFrames)) {
+		return 1;
+	}
+	if (!sRecordFile.empty()) {
+		app.StartRecording(sRecordFile);
+	}
+	if (app.Start() != engine::SUCCESS) {
+		return 1;
+	}
+	if (pHeadless && pHeadless->GetMismatchCount() > 0) {
+		std::cerr << pHeadless->GetMismatchCount() << " frames differ from the golden images in " << sGoldenDirectory << std::endl;
+		return 2;
 	}
 	return 0;
-}
\ No newline at end of file
+}
@@ -44,10 +44,20 @@ namespace app_const
 	constexpr float FROG_X_RESET = 8.0f;   ///< Frog x reset position (8.0f)
 	constexpr float FROG_Y_RESET = 9.0f;   ///< Frog y reset position (9.0f)
 
+	constexpr int LAYER_LANE_BACKGROUND = 0; ///< Draw layer of lane backgrounds and static lanes (0)
+	constexpr int LAYER_LANE_OBJECT = 1;     ///< Draw layer of lane objects (1)
+	constexpr int LAYER_SUMMON = 2;          ///< Draw layer of summoned objects (2)
+	constexpr int LAYER_PLAYER = 3;          ///< Draw layer of the player (3)
+	constexpr int LAYER_STATUS_BAR = 4;      ///< Draw layer of the status bar (4)
+	constexpr int LAYER_STATUS_TEXT = 5;     ///< Draw layer of the status bar text (5)
+
 	constexpr float TOP_BORDER = 0.0f;    ///< Top border (0.0f)
 	constexpr float BOTTOM_BORDER = 9.0f; ///< Bottom border (9.0f)
 	constexpr float LEFT_BORDER = 0.0f;   ///< Left border (0.0f)
 	constexpr float RIGHT_BORDER = 16.0f; ///< Right border (16.0f)
+
+	constexpr int FIELD_WIDTH = static_cast<int>(RIGHT_BORDER + 1) * CELL_SIZE;   ///< Playfield width (272) (in pixels), the status bar is on its right
+	constexpr int FIELD_HEIGHT = static_cast<int>(BOTTOM_BORDER + 1) * CELL_SIZE; ///< Playfield height (160) (in pixels)
 }
 
 #endif // U_APP_CONST_H